@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+
+// Startup options, filled from the command line in main.cpp
+struct AppConfig {
+    int width = 1280;
+    int height = 1080;
+    std::string title = "Toon Shaded Engine";
+
+    // Headless: offscreen context, no window, input or ImGui. Renders `frames`
+    // frames along the camera path at a fixed 1/fps step and exits.
+    bool headless = false;
+    int frames = 120;
+    double fps = 30.0;
+    std::string outputDir = "frames"; // frame_00000.png, ... and frame_stats.json; empty = render only
+    std::string cameraPath;           // keyframe file (see CameraPath); empty = orbit the scene
+    bool captureDepth = false;        // also write depth_00000.f32, ... (see FrameCapture)
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Model.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Loads models in the background and uploads them in small per-frame slices.
+ *
+ * Model::Import (mesh cache or Assimp, plus stb_image decoding) runs on a
+ * worker pool. Each finished import queues one GL job per mesh; update()
+ * drains that queue on the GL thread until a time budget is spent, so a
+ * large asset streams in over several frames instead of stalling one.
+ *
+ * Returned models start empty and gain meshes as their jobs run. They are
+ * tracked by the ResidencyManager: once evicted, drawing one again reloads
+ * it the same way (from the mesh cache, or from its kept CPU data).
+ */
+class AssetLoader {
+public:
+    /**
+     * @param threadCount Worker threads, 0 = hardware threads - 1 (the main thread keeps rendering)
+     */
+    explicit AssetLoader(unsigned int threadCount = 0);
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /**
+     * @brief Starts loading `path`. Never blocks; the model fills in over later update() calls.
+     * @param keepCpuData keep the import result in Model::cpuData after upload (otherwise it is freed)
+     */
+    std::shared_ptr<Model> loadModel(const std::string& path, bool keepCpuData = false);
+
+    /**
+     * @brief GL thread: runs queued uploads until `budgetMs` has elapsed (at least one job per call)
+     * @return number of jobs run
+     */
+    int update(double budgetMs);
+
+    // Imports still running on workers
+    int getPendingImports() const { return pendingImports_.load(); }
+    // GL jobs waiting for update()
+    size_t getPendingUploads() const;
+    bool isIdle() const { return getPendingImports() == 0 && getPendingUploads() == 0; }
+
+private:
+    std::deque<std::function<void()>> uploads_;
+    mutable std::mutex uploadMutex_;
+    std::atomic<int> pendingImports_{0};
+    std::atomic<bool> cancelled_{false};
+    std::unique_ptr<ThreadPool> pool_;
+    std::shared_ptr<AssetLoader*> self_; // restore callbacks hold it weakly, they may outlive the loader
+
+    void startImport(const std::shared_ptr<Model>& model, const std::string& path, bool keepCpuData);
+    void queueUpload(std::function<void()> job);
+};
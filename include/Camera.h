@@ -56,6 +56,9 @@ public:
     // Processes input received from a mouse scroll-wheel event
     void ProcessMouseScroll(float yoffset);
 
+    // Turns the camera towards a point (scripted camera paths)
+    void LookAt(const glm::vec3& target);
+
 private:
     // Calculates the front vector from the Camera's (updated) Euler Angles
     void updateCameraVectors();
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+
+struct CameraKey {
+    float time;         // seconds
+    glm::vec3 position;
+    glm::vec3 target;   // point looked at
+    float zoom;         // vertical FOV in degrees
+};
+
+// Scripted camera for headless renders: keyframes interpolated with Catmull-Rom
+class CameraPath {
+public:
+    // One key per line: "time px py pz tx ty tz [fov]", '#' starts a comment.
+    // Keys must be in time order.
+    bool Load(const std::string& path);
+
+    // One full turn around center every `period` seconds
+    static CameraPath Orbit(const glm::vec3& center, float radius, float height, float period);
+
+    void AddKey(const CameraKey& key) { keys.push_back(key); }
+
+    // Clamped to the first/last key outside the path's time range
+    void Apply(Camera& camera, float time) const;
+
+    bool IsEmpty() const { return keys.empty(); }
+    float GetDuration() const { return keys.empty() ? 0.0f : keys.back().time - keys.front().time; }
+
+private:
+    std::vector<CameraKey> keys;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include "Frustum.h"
+
+/**
+ * Dynamic AABB tree (in the style of Box2D's b2DynamicTree) for culling
+ * moving drawables. Leaves store a "fat" box, the real one grown by a
+ * margin, so small moves leave the tree alone; a leaf is only reinserted
+ * once its object leaves the fat box. Inserts pick the sibling with the
+ * least surface area growth and rotations keep the tree balanced.
+ */
+class DynamicBvh {
+public:
+    explicit DynamicBvh(float margin = 0.1f);
+
+    // Returns a proxy id that stays valid until DestroyProxy
+    int CreateProxy(const AABB& box, int userData);
+    void DestroyProxy(int proxy);
+    // Reinserts the proxy only if `box` is no longer inside its fat box. Returns true if it did.
+    bool MoveProxy(int proxy, const AABB& box);
+    void Clear();
+
+    int GetUserData(int proxy) const { return nodes[proxy].userData; }
+    const AABB& GetFatAABB(int proxy) const { return nodes[proxy].box; }
+
+    // Appends the user data of every leaf not outside the frustum
+    void Query(const Frustum& frustum, std::vector<int>& userData) const;
+
+    // Statistics
+    int GetProxyCount() const { return proxyCount; }
+    int GetHeight() const { return root < 0 ? 0 : nodes[root].height; }
+    int GetLastNodesTested() const { return lastNodesTested; }
+
+private:
+    struct Node {
+        AABB box;
+        int parent;   // next free node while on the free list
+        int child1;   // -1 for leaves
+        int child2;
+        int height;   // leaves are 0, -1 while free
+        int userData;
+
+        bool IsLeaf() const { return child1 < 0; }
+    };
+
+    std::vector<Node> nodes;
+    int root;
+    int freeList;
+    int proxyCount;
+    float margin;
+    mutable int lastNodesTested;
+    mutable std::vector<int> stack;
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int node);
+    void collectLeaves(int node, std::vector<int>& userData) const;
+};
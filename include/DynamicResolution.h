@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Picks the scene's render scale from its measured GPU time.
+ *
+ * beginFrame()/endFrame() bracket the scene and post-process passes with a
+ * GL_TIME_ELAPSED query; results are read kLatency frames later and only once
+ * available, so nothing waits on the GPU. Pixel cost grows with the square of
+ * the scale, so each reading moves the scale towards
+ * scale * sqrt(headroom * target / measured): quickly when over budget,
+ * slowly when there is time to spare, and not at all inside a small deadband,
+ * which keeps the image from pumping.
+ *
+ * GL thread only.
+ */
+class DynamicResolution {
+public:
+    static constexpr int kLatency = 4; // queries in flight
+
+    DynamicResolution() = default;
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    /**
+     * @brief Collects finished timings, updates the scale and starts timing this frame
+     */
+    void beginFrame();
+    void endFrame();
+
+    /**
+     * @brief Scale for this frame's scene pass, in [minScale, maxScale] (fixed when disabled)
+     */
+    float getScale() const { return enabled_ ? scale_ : fixedScale_; }
+
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return enabled_; }
+
+    // GPU budget for scene + post process; leave some of the frame for the UI and the swap
+    void setTargetMs(float ms) { targetMs_ = ms; }
+    float getTargetMs() const { return targetMs_; }
+
+    void setScaleRange(float minScale, float maxScale);
+    float getMinScale() const { return minScale_; }
+    float getMaxScale() const { return maxScale_; }
+
+    // Used while disabled
+    void setFixedScale(float scale) { fixedScale_ = scale; }
+    float getFixedScale() const { return fixedScale_; }
+
+    // Smoothed GPU time of scene + post process
+    double getGpuMs() const { return filteredMs_; }
+
+    /**
+     * @brief GL thread, before the context goes away
+     */
+    void shutdownGpu();
+
+private:
+    bool enabled_ = false;
+    float targetMs_ = 14.0f;
+    float minScale_ = 0.5f;
+    float maxScale_ = 1.0f;
+    float fixedScale_ = 1.0f;
+    float scale_ = 1.0f;
+    double filteredMs_ = 0.0;
+
+    unsigned int queries_[kLatency] = {};
+    bool pending_[kLatency] = {};
+    uint64_t frame_ = 0;
+    bool active_ = false;
+
+    void adjust(double gpuMs);
+};
@@ -21,4 +21,15 @@ public:
         // 4. Return as string
         return fullPath.string();
     }
+
+    // Location for generated data (compiled models, mesh/texture caches) under <root>/.cache.
+    // Parent directories are created on demand.
+    static std::string getCachePath(const std::string& relativePath) {
+        std::filesystem::path fullPath = std::filesystem::path(logl_root) / ".cache" / relativePath;
+
+        std::error_code ec;
+        std::filesystem::create_directories(fullPath.parent_path(), ec);
+
+        return fullPath.string();
+    }
 };
\ No newline at end of file
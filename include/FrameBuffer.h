@@ -1,34 +1,38 @@
 #pragma once
 
 #include <glad/glad.h>
-#include "Shader.h"
+#include "RenderTargetPool.h"
 
+// The scene's color + depth targets for one frame, taken from the RenderTargetPool.
+// With a render scale below 1 the scene covers only the bottom-left
+// viewportWidth x viewportHeight of them; the targets keep their size, so a
+// changing scale never reallocates (the post pass upscales the sub-rect).
 class FrameBuffer {
 public:
-    // Dimensions
-    int width;
-    int height;
-
-    // Constructor
-    FrameBuffer(int scrWidth, int scrHeight);
+    // Dimensions of the current frame's targets
+    int width = 0;
+    int height = 0;
+    // Part of them the scene was drawn into
+    int viewportWidth = 0;
+    int viewportHeight = 0;
+
+    explicit FrameBuffer(RenderTargetPool& pool);
     ~FrameBuffer();
 
-    // Re-generates textures when window resizes
-    void Resize(int newWidth, int newHeight);
+    // Call this before drawing your 3D scene: acquires this frame's targets and binds them
+    void Bind(int newWidth, int newHeight, float scale = 1.0f);
 
-    // Call this before drawing your 3D scene
-    void Bind();
+    // Hands the targets back once nothing reads them any more; later passes may reuse them
+    void Release();
 
-    // Call this after drawing 3D scene to render the final image
-    void DrawToScreen(Shader& postProcessShader);
+    // Read by the post-process passes (see PostProcessGraph)
+    unsigned int GetColorTexture() const { return color ? color->texture : 0; }
+    unsigned int GetDepthTexture() const { return depth ? depth->texture : 0; }
+    unsigned int GetFBO() const { return fbo; }
 
 private:
-    unsigned int fbo;       // Framebuffer Object
-    unsigned int texID;     // Color Texture
-    unsigned int depthTexID; // <--- CHANGED: Depth Texture (was RBO)
-    
-    unsigned int rectVAO, rectVBO; // Screen Quad Geometry
-
-    void setupFramebuffer();
-    void setupScreenQuad();
-};
\ No newline at end of file
+    RenderTargetPool& pool;
+    RenderTarget* color = nullptr;
+    RenderTarget* depth = nullptr;
+    unsigned int fbo = 0; // owned by the pool
+};
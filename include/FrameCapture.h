@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+
+/**
+ * @brief Records rendered frames without stalling the GL thread.
+ *
+ * capture() issues glReadPixels into a pixel-pack buffer followed by a fence and
+ * returns immediately; the copy happens on the GPU. A few frames later poll()
+ * finds the fence signalled, maps the buffer and hands the pixels to writer
+ * threads that encode PNGs or append to a raw RGB stream. Color comes from the
+ * presented image, depth (optional, float) from the scene framebuffer.
+ *
+ * All methods except the statistics are GL thread only.
+ */
+class FrameCapture {
+public:
+    enum class Format {
+        Png, // frame_00000.png, ... (depth: depth_00000.f32)
+        Raw  // color.rgb, one top-down RGB24 frame after another (depth: depth.f32)
+    };
+
+    struct Settings {
+        std::string outputDir = "capture";
+        Format format = Format::Png;
+        bool captureDepth = false;
+        int ringSize = 3;            // readbacks in flight, i.e. frames of latency
+        size_t maxQueuedFrames = 8;  // waiting for the writers; bounds memory
+        bool dropWhenBehind = true;  // false: wait for the writers (offline renders)
+        unsigned int pngThreads = 2; // PNG encoding is slow; raw streams always use one writer
+        double fps = 60.0;           // only for the ffmpeg command printed when a raw stream stops
+    };
+
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * @brief Creates the output directory and the readback ring, starts the writers
+     */
+    bool start(const Settings& settings);
+
+    /**
+     * @brief Finishes the readbacks in flight, waits for the writers and frees the buffers
+     */
+    void stop();
+
+    bool isRecording() const { return recording_; }
+    const Settings& getSettings() const { return settings_; }
+
+    /**
+     * @brief Starts reading back the finished frame. Call after it is drawn, before the swap.
+     * @param colorFbo framebuffer holding the final image (0 = the window)
+     * @param depthFbo framebuffer whose depth attachment to read when captureDepth is set; it may
+     *        be smaller than the image (scene rendered at a lower resolution)
+     */
+    void capture(unsigned int colorFbo, int width, int height, unsigned int depthFbo, int depthWidth, int depthHeight);
+
+    /**
+     * @brief Collects readbacks whose fences have signalled. capture() calls it too.
+     */
+    void poll();
+
+    // Statistics
+    uint64_t getCapturedFrames() const { return captured_; }
+    uint64_t getWrittenFrames() const { return written_.load(); }
+    uint64_t getDroppedFrames() const { return dropped_.load(); }
+    uint64_t getStalls() const { return stalls_; }  // ring full: capture() had to wait on the GPU
+    size_t getQueuedFrames() const { return queued_.load(); }
+    double getLastCpuMs() const { return lastCpuMs_; } // GL thread time of the last capture()
+
+private:
+    struct Slot {
+        unsigned int colorPbo = 0;
+        unsigned int depthPbo = 0;
+        void* fence = nullptr; // GLsync
+        size_t colorBytes = 0; // PBO capacity
+        size_t depthBytes = 0;
+        int width = 0;
+        int height = 0;
+        int depthWidth = 0;
+        int depthHeight = 0;
+        bool depth = false;
+        uint64_t index = 0;
+    };
+
+    struct Frame {
+        uint64_t index;
+        int width;
+        int height;
+        int depthWidth;
+        int depthHeight;
+        std::vector<unsigned char> color; // RGBA8, bottom row first (GL order)
+        std::vector<float> depth;
+    };
+
+    Settings settings_;
+    bool recording_ = false;
+
+    std::vector<Slot> slots_;
+    size_t head_ = 0;     // next slot to issue
+    size_t inFlight_ = 0;
+    uint64_t captured_ = 0;
+    uint64_t stalls_ = 0;
+    double lastCpuMs_ = 0.0;
+
+    std::unique_ptr<ThreadPool> writers_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::mutex queueMutex_;
+    std::condition_variable queueSpace_;
+
+    // Recycled pixel storage, so steady recording does not allocate
+    std::mutex poolMutex_;
+    std::vector<std::unique_ptr<Frame>> pool_;
+
+    // Raw streams, only touched by the single raw writer
+    FILE* colorStream_ = nullptr;
+    FILE* depthStream_ = nullptr;
+    int streamWidth_ = 0;
+    int streamHeight_ = 0;
+    int streamDepthWidth_ = 0;
+    int streamDepthHeight_ = 0;
+
+    void collect(Slot& slot);
+    void submit(std::unique_ptr<Frame> frame);
+    void write(Frame& frame);
+    std::unique_ptr<Frame> acquireFrame();
+    void releaseFrame(std::unique_ptr<Frame> frame);
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One recorded frame
+struct FrameSample {
+    uint64_t index;   // frames since the recorder started
+    double time;      // seconds since the recorder started, at the end of the frame
+    float frameMs;    // wall time since the previous frame
+    float gpuMs;      // GPU time if known (see Profiler), else 0
+    bool hitch;
+};
+
+/**
+ * @brief Rolling frame-time statistics for spotting stutters rather than averages.
+ *
+ * tick() measures the frame on the steady clock in double precision. The
+ * last `window` frames are kept in a ring alongside a fixed-bucket histogram
+ * (0.1 ms up to kHistogramMs, then one overflow bucket), so percentiles cost
+ * O(buckets) no matter how long the session runs. A frame is a hitch when it
+ * takes more than hitchFactor times the window's median and at least
+ * hitchMinMs. Windows can be dumped per frame as CSV or JSON for soak runs.
+ */
+class FrameStats {
+public:
+    static constexpr float kBucketMs = 0.1f;
+    static constexpr float kHistogramMs = 250.0f;
+
+    struct Summary {
+        size_t frames = 0;
+        double averageMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        uint64_t hitches = 0;      // in the window
+        uint64_t totalHitches = 0; // since start
+    };
+
+    explicit FrameStats(size_t window = 3600);
+
+    /**
+     * @brief Ends the current frame: records it and returns its length in seconds (0 for the first call)
+     * @param gpuMs GPU time of a recent frame, stored alongside (0 if unknown)
+     */
+    double tick(float gpuMs = 0.0f);
+
+    // Frames kept for percentiles and dumps; shrinking drops the oldest
+    void setWindow(size_t frames);
+    size_t getWindow() const { return capacity_; }
+
+    void setHitchThreshold(float factor, float minMs) { hitchFactor_ = factor; hitchMinMs_ = minMs; }
+
+    Summary getSummary() const;
+    // Value below which `fraction` (0-1) of the window's frames fall, from the histogram
+    double getPercentile(double fraction) const;
+
+    // Oldest first
+    std::vector<FrameSample> getSamples() const;
+    // Frame times of the window, oldest first (for ImGui::PlotLines)
+    void copyFrameTimes(std::vector<float>& out) const;
+
+    // Per-frame dumps of the window (the last `frames` of it if non-zero)
+    bool writeCsv(const std::string& path, size_t frames = 0) const;
+    bool writeJson(const std::string& path, size_t frames = 0) const;
+
+    void reset();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<FrameSample> ring_;
+    size_t capacity_;
+    size_t head_ = 0; // next slot to write
+    size_t count_ = 0;
+    std::vector<uint32_t> histogram_;
+    double sumMs_ = 0.0;
+    uint64_t frameIndex_ = 0;
+    uint64_t totalHitches_ = 0;
+    float hitchFactor_ = 2.0f;
+    float hitchMinMs_ = 8.0f;
+
+    Clock::time_point start_;
+    Clock::time_point last_;
+    bool started_ = false;
+
+    static size_t bucketOf(float ms);
+    void push(const FrameSample& sample);
+    void popOldest();
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cfloat>
+
+// Axis-aligned box. Default constructed it is empty (min > max) and grows with Expand.
+struct AABB {
+    glm::vec3 min = glm::vec3(FLT_MAX);
+    glm::vec3 max = glm::vec3(-FLT_MAX);
+
+    AABB() = default;
+    AABB(const glm::vec3& min, const glm::vec3& max) : min(min), max(max) {}
+
+    bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+    glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+    void Expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    void Expand(const AABB& box) {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
+
+    bool Contains(const AABB& box) const {
+        return min.x <= box.min.x && min.y <= box.min.y && min.z <= box.min.z &&
+               max.x >= box.max.x && max.y >= box.max.y && max.z >= box.max.z;
+    }
+
+    float GetSurfaceArea() const {
+        glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    // Box around this box after an affine transform (Arvo's method: exact for the 8 corners)
+    AABB Transformed(const glm::mat4& m) const;
+
+    static AABB Union(const AABB& a, const AABB& b) {
+        return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+    }
+};
+
+enum FrustumTest {
+    FRUSTUM_OUTSIDE,
+    FRUSTUM_INTERSECTS,
+    FRUSTUM_INSIDE,
+};
+
+/**
+ * The six clip planes of a view-projection matrix, stored as a structure of
+ * arrays so one box is tested against four planes per SIMD instruction
+ * (SSE2 or NEON, with a scalar fallback).
+ */
+class Frustum {
+public:
+    Frustum(); // accepts everything
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    void Set(const glm::mat4& viewProjection);
+
+    FrustumTest Test(const AABB& box) const;
+    bool IsVisible(const AABB& box) const { return Test(box) != FRUSTUM_OUTSIDE; }
+
+private:
+    // Planes 0-5: left, right, bottom, top, near, far. 6 and 7 repeat plane 0 to fill two batches of four.
+    alignas(16) float nx[8], ny[8], nz[8], d[8];
+    alignas(16) float ax[8], ay[8], az[8]; // |normal|, for the box extent term
+};
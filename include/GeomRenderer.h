@@ -0,0 +1,154 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <mujoco/mujoco.h>
+
+#include <vector>
+#include "Mesh.h"
+#include "MeshSimplifier.h"
+#include "Shader.h"
+#include "RenderQueue.h"
+#include "LodSelector.h"
+#include "DynamicBvh.h"
+#include "Physics.h"
+#include "PhysicsThread.h"
+
+/**
+ * @brief Draws every MuJoCo geom of a model with one instanced draw call per
+ * mesh/primitive group and LOD. Per-instance model matrices come from
+ * MujocoSim::exportGeomPoses and only the geoms that moved are re-uploaded.
+ *
+ * Instance matrices and colors live in buffer textures; each (group, LOD)
+ * draw reads a list of instance indices as its only instanced attribute, so
+ * instances can change LOD, or be culled, without moving their matrices
+ * around. World bounds of moved geoms are refit in a DynamicBvh on Update.
+ */
+class GeomRenderer {
+public:
+    GeomRenderer();
+    ~GeomRenderer();
+
+    // Owns GL objects
+    GeomRenderer(const GeomRenderer&) = delete;
+    GeomRenderer& operator=(const GeomRenderer&) = delete;
+
+    /**
+     * @brief Builds group geometry and instance buffers for a compiled model.
+     * Only geoms whose geom_group is enabled (see SetGeomGroupVisible) are included.
+     */
+    void Build(const mjModel* m);
+
+    /**
+     * @brief Uploads the world pose of every instanced geom that moved since the last update
+     */
+    void Update(MujocoSim& sim);
+
+    /**
+     * @brief Same as above, but reads poses published by a physics thread and
+     * interpolates between its last two snapshots for a render at wallNow.
+     */
+    void Update(const PhysicsThread& physics, double wallNow);
+
+    /**
+     * @brief Culls instances against the frustum, picks a LOD per visible mesh instance and
+     * queues one instanced packet per group and used LOD. worldTransform goes in as the
+     * ObjectData model (and is assumed fixed: bounds are only refit for geoms that move).
+     */
+    void Submit(RenderQueue& queue, Shader& shader, const LodView& lodView, const Frustum& frustum);
+
+    /**
+     * @brief Enables/disables a MuJoCo geom group (0-5). Takes effect on the next Build.
+     * Defaults match MuJoCo's viewer: groups 0, 1 and 2 visible.
+     */
+    void SetGeomGroupVisible(int group, bool visible);
+
+    // MuJoCo is Z-up, the engine is Y-up
+    glm::mat4 worldTransform;
+
+    int GetGroupCount() const { return static_cast<int>(groups.size()); }
+    int GetInstanceCount() const { return static_cast<int>(instanceGeoms.size()); }
+    size_t GetLastUploadBytes() const { return lastUploadBytes; }
+    // Instances drawn below full detail by the last Submit
+    int GetSimplifiedInstanceCount() const { return simplifiedInstances; }
+    // Instances drawn/culled by the last Submit
+    int GetVisibleInstanceCount() const { return visibleInstances; }
+    int GetCulledInstanceCount() const { return GetInstanceCount() - visibleInstances; }
+
+private:
+    // Per-instance data that never changes after Build
+    struct InstanceStatic {
+        glm::vec4 scale; // xyz = primitive size, w unused
+        glm::vec4 color;
+    };
+
+    // One level of a group's geometry; all levels index the group's VBO
+    struct GroupLod {
+        GLsizei firstIndex;
+        GLsizei indexCount;
+        unsigned int VAO; // group vertices + this level's block of instance ids
+    };
+
+    // Geoms sharing a mesh or primitive shape: one instanced draw per LOD in use
+    struct GeomGroup {
+        int type;
+        int dataid;          // mesh id for mjGEOM_MESH, -1 otherwise
+        glm::vec2 shapeKey;  // capsule radius/half-length (shape is not scale invariant)
+        unsigned int VBO, EBO; // PackedVertex, quantized inside localBounds
+        GLenum indexType;    // GL_UNSIGNED_SHORT when the vertices fit
+        glm::vec3 positionScale, positionBias; // ObjectData dequantization
+        float radius;        // around the geom origin, before instance scale
+        AABB localBounds;    // same
+        int firstInstance;
+        int instanceCount;
+        int firstId;         // levels * instanceCount ids in instanceIds, one block per level
+        std::vector<GroupLod> lods;
+        std::vector<float> lodErrors;
+    };
+
+    std::vector<GeomGroup> groups;
+    std::vector<int> instanceGeoms;        // geom ids, sorted so each group is contiguous
+    std::vector<glm::mat4> instanceModels; // CPU mirror of the instance buffer
+    std::vector<glm::mat4> geomModels;     // exportGeomPoses target, indexed by geom id
+    std::vector<int> instanceSlot;         // geom id -> instance index, -1 if not drawn
+    std::vector<int> changedGeoms;
+    std::vector<int> dirtySlots;
+
+    // LOD state
+    std::vector<int> instanceIds;     // CPU mirror of instanceIdVBO
+    std::vector<int> instanceLods;    // per instance, last level drawn (-1 before the first)
+    std::vector<float> instanceScale; // largest primitive scale per instance
+    std::vector<int> levelFill;
+    int simplifiedInstances;
+
+    // Culling state
+    DynamicBvh bvh;                          // one proxy per instance, user data = instance index
+    std::vector<int> instanceProxy;
+    std::vector<AABB> instanceLocalBounds;   // group bounds times the instance's scale
+    std::vector<int> visibleSlots;
+    std::vector<char> instanceVisible;
+    int visibleInstances;
+
+    // Snapshot interpolation state
+    std::vector<int> interpGeoms;   // geoms moving between the previous and current snapshot
+    std::vector<char> interpMark;
+    uint64_t lastSequence;
+    bool interpDone;
+
+    unsigned int instanceModelVBO;
+    unsigned int instanceStaticVBO;
+    unsigned int instanceIdVBO;
+    unsigned int instanceModelTexture;  // GL_TEXTURE_BUFFER views of the two buffers above
+    unsigned int instanceStaticTexture;
+    RenderMaterial instanceMaterial;
+    bool needsFullExport;
+    size_t lastUploadBytes;
+    bool groupVisible[6];
+
+    void clear();
+    void setupGroup(GeomGroup& group, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                    const std::vector<LodLevel>& lods);
+    void uploadDirtySlots();
+    void refitDirtySlots();
+    AABB instanceBounds(int slot) const;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+struct VertexAttribute {
+    GLuint location;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    size_t offset;
+};
+
+// Vertex formats with a pool of their own
+enum class VertexFormat {
+    Standard, // Vertex: float position, normal and UV (32 bytes)
+    Packed,   // PackedVertex: quantized position, 10:10:10:2 normal, half UV (16 bytes)
+};
+
+// Interleaved vertex format shared by every mesh in a pool
+struct VertexLayout {
+    GLsizei stride;
+    std::vector<VertexAttribute> attributes;
+};
+
+// Where one mesh lives inside a GeometryPool
+struct GeometryAllocation {
+    GLint baseVertex = -1;   // first vertex in the pool's vertex buffer, -1 if unallocated
+    GLsizei vertexCount = 0;
+    GLsizei firstIndex = 0;  // first index in the pool's index buffer (indices are mesh-relative)
+    GLsizei indexCount = 0;
+
+    bool IsValid() const { return baseVertex >= 0; }
+};
+
+// First-fit free list over [0, capacity) elements; neighbouring free ranges are merged
+class RangeAllocator {
+public:
+    explicit RangeAllocator(size_t capacity);
+
+    bool Allocate(size_t size, size_t& offset);
+    void Free(size_t offset, size_t size);
+    void Grow(size_t capacity); // appends [old capacity, capacity) to the free list
+
+    size_t GetCapacity() const { return capacity; }
+    size_t GetUsed() const { return used; }
+
+private:
+    std::map<size_t, size_t> freeRanges; // offset -> size
+    size_t capacity;
+    size_t used;
+};
+
+/**
+ * One large vertex buffer and index buffer (behind a single VAO) holding
+ * many meshes of the same vertex layout and index type. Meshes are drawn
+ * with base-vertex offsets, so a whole model can go out in one
+ * glMultiDrawElementsBaseVertex. Buffers grow by copying on the GPU;
+ * existing allocations keep their offsets.
+ */
+class GeometryPool {
+public:
+    GeometryPool(const VertexLayout& layout, GLenum indexType, size_t vertexCapacity, size_t indexCapacity);
+    ~GeometryPool();
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    // Shared pool for a vertex format and index type (GL_UNSIGNED_SHORT/INT), created on first use (GL thread)
+    static GeometryPool& Get(VertexFormat format, GLenum indexType);
+    // GL thread, before the context goes away. Every Mesh must be gone by then.
+    static void DestroyAll();
+    // Attribute layout of a format; buffers outside the pools (instanced geoms) use it too
+    static VertexLayout GetLayout(VertexFormat format);
+
+    // Totals over the shared pools (GL thread)
+    static int GetPoolCount() { return static_cast<int>(pools.size()); }
+    static size_t GetTotalVertexCount();
+    static size_t GetTotalBufferBytes();
+
+    // GL thread: copies the arrays into the pool, growing the buffers if needed. Indices are of GetIndexType().
+    GeometryAllocation Allocate(const void* vertexData, size_t vertexCount, const void* indexData, size_t indexCount);
+    // GL thread: another index list over an existing allocation's vertices (LODs share their vertex range)
+    GeometryAllocation AllocateIndices(const GeometryAllocation& vertices, const void* indexData, size_t indexCount);
+    // Any thread: returns the ranges to the free lists (no GL calls)
+    void Free(const GeometryAllocation& allocation);
+
+    unsigned int GetVAO() const { return VAO; }
+    GLenum GetIndexType() const { return indexType; }
+    size_t GetIndexSize() const { return indexType == GL_UNSIGNED_SHORT ? 2 : 4; }
+    size_t GetVertexSize() const { return layout.stride; }
+    size_t GetVertexCapacity() const { return vertexRanges.GetCapacity(); }
+    size_t GetVertexCount() const { return vertexRanges.GetUsed(); }
+    size_t GetIndexCapacity() const { return indexRanges.GetCapacity(); }
+    size_t GetIndexCount() const { return indexRanges.GetUsed(); }
+    size_t GetBufferBytes() const;
+
+private:
+    VertexLayout layout;
+    GLenum indexType;
+    unsigned int VAO, VBO, EBO;
+    RangeAllocator vertexRanges, indexRanges;
+    mutable std::mutex mutex; // Free can come from a loader thread dropping the last Model reference
+
+    static std::map<std::pair<VertexFormat, GLenum>, std::unique_ptr<GeometryPool>> pools;
+
+    void growBuffer(unsigned int& buffer, size_t oldBytes, size_t newBytes);
+    bool allocateIndexRange(size_t indexCount, size_t& indexOffset); // true if the index buffer grew
+    void bindLayout();
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Non-cryptographic content hashing (64-bit FNV-1a) for cache keys.
+ */
+class Hash {
+public:
+    static constexpr uint64_t kSeed = 14695981039346656037ull;
+
+    // Feed `seed` with a previous result to hash several buffers as one stream
+    static uint64_t fnv1a(const void* data, size_t size, uint64_t seed = kSeed) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static uint64_t fnv1a(const std::string& text, uint64_t seed = kSeed) {
+        return fnv1a(text.data(), text.size(), seed);
+    }
+
+    /**
+     * @brief Hashes a file's contents into `hash` (used as the seed)
+     * @return false if the file can't be read
+     */
+    static bool file(const std::string& path, uint64_t& hash) {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream.is_open()) return false;
+
+        std::vector<char> chunk(1 << 16);
+        while (stream) {
+            stream.read(chunk.data(), chunk.size());
+            hash = fnv1a(chunk.data(), static_cast<size_t>(stream.gcount()), hash);
+        }
+        return true;
+    }
+
+    static std::string toHex(uint64_t hash) {
+        char text[17];
+        std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+        return text;
+    }
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// Offscreen GL 4.1 core context for rendering without a window.
+// Built with TOON_HAS_EGL it uses EGL (surfaceless where the driver supports
+// it, e.g. Mesa or a headless GPU), so no display server is needed. Otherwise,
+// or if EGL fails, it falls back to a hidden GLFW window, which still needs a
+// display (Xvfb on servers). Nothing is ever presented: render into FBOs.
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // Makes the context current and loads GL through glad
+    bool Create(int width, int height);
+    void Destroy();
+
+    const char* GetBackend() const { return usingEgl ? "EGL" : "GLFW (hidden)"; }
+
+private:
+    // EGL handles, opaque here so the header does not pull in EGL
+    void* eglDisplay = nullptr;
+    void* eglContext = nullptr;
+    void* eglSurface = nullptr;
+    bool usingEgl = false;
+
+    GLFWwindow* window = nullptr;
+
+    bool createEgl();
+    bool createGlfw(int width, int height);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+
+// Camera side of LOD selection, filled in once per frame
+struct LodView {
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    float pixelsPerUnit = 1.0f;  // viewport height / (2 tan(fovy / 2)): pixels per world unit at distance 1
+    float maxPixelError = 1.0f;  // how far a level may deviate from the full mesh on screen
+    float hysteresis = 0.25f;    // going coarser must also fit (1 - hysteresis) * maxPixelError
+};
+
+/**
+ * @brief Screen-space error LOD selection.
+ *
+ * A level's object-space error (see MeshSimplifier) covers
+ * error * scale * pixelsPerUnit / distance pixels; the coarsest level within
+ * maxPixelError wins. Refining happens at once, coarsening only when the
+ * level also clears the tighter budget, so objects sitting right at a
+ * switching distance don't flicker between two levels.
+ */
+class LodSelector {
+public:
+    static float projectedError(float worldError, float distance, const LodView& view) {
+        return worldError * view.pixelsPerUnit / std::max(distance, 1e-3f);
+    }
+
+    /**
+     * @param errors object-space error per level, 0 for level 0, non-decreasing
+     * @param scale world units per object unit
+     * @param distance from the camera to the object's bounding sphere (not its center)
+     * @param current level picked last frame, -1 if none
+     */
+    static int select(const float* errors, int levelCount, float scale, float distance, const LodView& view, int current) {
+        int level = 0;
+        while (level + 1 < levelCount && projectedError(errors[level + 1] * scale, distance, view) <= view.maxPixelError)
+            ++level;
+        if (current < 0 || level <= current) return level;
+
+        // Coarser than last frame: only as far as the tighter budget allows
+        float budget = view.maxPixelError * (1.0f - view.hysteresis);
+        int coarse = std::min(current, levelCount - 1);
+        while (coarse < level && projectedError(errors[coarse + 1] * scale, distance, view) <= budget)
+            ++coarse;
+        return coarse;
+    }
+};
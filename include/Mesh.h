@@ -1,8 +1,16 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "Shader.h"
+#include "RenderQueue.h"
+#include "GeometryPool.h"
+#include "Frustum.h"
+
+struct CachedTexture;
 
 struct Vertex {
     glm::vec3 Position;
@@ -10,28 +18,75 @@ struct Vertex {
     glm::vec2 TexCoords;
 };
 
+// Compact alternative to Vertex (16 bytes instead of 32), see VertexPacking
+struct PackedVertex {
+    uint16_t Position[4];  // unorm16 inside the model bounds; dequantized with ObjectData.positionScale/Bias
+    uint32_t Normal;       // snorm 10:10:10:2 (GL_INT_2_10_10_10_REV)
+    uint16_t TexCoords[2]; // half floats
+};
+
 struct Texture {
     unsigned int id;
     std::string type; // e.g. "texture_diffuse"
-    std::string path; // To prevent loading the same texture twice
+    std::string path;
+    std::shared_ptr<const CachedTexture> handle; // Keeps the shared GL texture alive (see TextureCache)
 };
 
 class Mesh {
 public:
-    // Data
+    // Data. Only filled when the vector constructor was asked to keep a CPU copy.
     std::vector<Vertex>       vertices;
     std::vector<unsigned int> indices;
     std::vector<Texture>      textures; // New!
     bool hasTexture; // <--- Add this to check if texture exists
     glm::vec3 baseColor; // <--- Add this to store the fallback color
+    AABB bounds;         // object space; from the vertices, or set by the importer
+
+    unsigned int indexCount = 0;
+
+    // Takes ownership of the arrays (move them in) and frees them after upload unless keepCpuData is set
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures,
+         const glm::vec3& baseColor = glm::vec3(1.0f), bool keepCpuData = false);
+    // Uploads straight from caller-owned arrays (e.g. a mapped mesh cache); keeps no CPU copy
+    Mesh(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount, std::vector<Texture> textures,
+         const glm::vec3& baseColor = glm::vec3(1.0f));
+    // Same, for any vertex format and GL_UNSIGNED_SHORT or GL_UNSIGNED_INT indices
+    Mesh(VertexFormat format, const void* vertices, size_t vertexCount, GLenum indexType, const void* indices, size_t indexCount,
+         std::vector<Texture> textures, const glm::vec3& baseColor = glm::vec3(1.0f));
+    ~Mesh();
+
+    // Owns a range of the geometry pool: movable, not copyable
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
+
+    // Where the vertices/indices live; meshes in the same pool share one VAO (see Model::Submit)
+    const GeometryAllocation& GetGeometry() const { return geometry; }
+    unsigned int GetVAO() const { return pool ? pool->GetVAO() : 0; }
+    GLenum GetIndexType() const { return pool ? pool->GetIndexType() : GL_UNSIGNED_INT; }
+    VertexFormat GetVertexFormat() const { return format; }
+    const RenderMaterial& GetMaterial() const { return material; }
 
-    // Constructor
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
+    // Appends a coarser index list over the same vertices (indices of GetIndexType()), GL thread
+    void AddLod(const void* indices, size_t indexCount, float error);
+    int GetLodCount() const { return 1 + static_cast<int>(lods.size()); }
+    // Level 0 is the full mesh; levels past the last one return the coarsest
+    const GeometryAllocation& GetLod(int level) const;
+    float GetLodError(int level) const; // object-space deviation from level 0
 
-    // Render
-    void Draw(unsigned int shaderProgram);
+    // Residency accounting: kept vertices/indices, and the pool ranges this mesh holds (every LOD)
+    size_t GetCpuBytes() const;
+    size_t GetGpuBytes() const;
 
 private:
-    unsigned int VAO, VBO, EBO;
-    void setupMesh();
+    GeometryPool* pool = nullptr;
+    GeometryAllocation geometry;
+    std::vector<GeometryAllocation> lods; // index-only ranges sharing geometry's vertices
+    std::vector<float> lodErrors;
+    VertexFormat format = VertexFormat::Standard;
+    RenderMaterial material; // texture ids and their samplers, e.g. "texture_diffuse2"; resolved once
+    void resolveMaterial();
+    void releaseGeometry();
+    void setupMesh(VertexFormat format, const void* vertexData, size_t vertexCount, GLenum indexType, const void* indexData, size_t indexCount);
 };
\ No newline at end of file
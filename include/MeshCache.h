@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+#include "Frustum.h"
+#include "MappedFile.h"
+
+// A texture a mesh references: a file relative to the model, or embedded bytes ('*N' paths)
+struct TextureRef {
+    std::string type; // e.g. "texture_diffuse"
+    std::string path;
+    const unsigned char* embeddedData = nullptr; // points into the aiScene or the cache mapping
+    size_t embeddedSize = 0;
+    std::string cacheKey; // TextureCache key, filled in by Model::Import (not stored in the file)
+};
+
+// Non-owning view of a simplified index list over a mesh's vertices (see MeshSimplifier)
+struct LodSource {
+    const unsigned int* indices = nullptr;
+    size_t indexCount = 0;
+    float error = 0.0f; // object-space deviation from the full mesh
+};
+
+// Non-owning view of one mesh's final vertex/index arrays
+struct MeshSource {
+    const Vertex* vertices = nullptr;
+    size_t vertexCount = 0;
+    const unsigned int* indices = nullptr;
+    size_t indexCount = 0;
+    glm::vec3 baseColor = glm::vec3(1.0f); // material diffuse color, used when there is no texture
+    AABB bounds;                           // object space, computed at import
+    std::vector<TextureRef> textures;
+    std::vector<LodSource> lods; // coarser levels, finest first
+};
+
+/**
+ * @brief Binary cache of post-import meshes (.tmesh under .cache/meshes).
+ *
+ * Stores the final Vertex/index arrays, bounds, LOD index lists, texture
+ * references and embedded texture bytes per Mesh. Files are memory-mapped
+ * on load and the returned MeshSource views point straight into the mapping,
+ * so they can be handed to glBufferData without intermediate copies.
+ */
+class MeshCache {
+public:
+    // Bump when the layout or the import pipeline output changes
+    static constexpr uint32_t kVersion = 5;
+
+    /**
+     * @brief Cache file location for a model path
+     */
+    static std::string pathFor(const std::string& modelPath);
+
+    /**
+     * @brief Hashes the model file and the side files it pulls in (OBJ mtllib, glTF buffers)
+     */
+    static bool hashSource(const std::string& modelPath, uint64_t& hash);
+
+    /**
+     * @brief Maps `cachePath` and fills `meshes` with views into it.
+     * @return false if the file is missing, corrupt or was built from different inputs
+     */
+    static bool read(const std::string& cachePath, uint32_t importFlags, uint64_t sourceHash,
+                     MappedFile& file, std::vector<MeshSource>& meshes);
+
+    static bool write(const std::string& cachePath, uint32_t importFlags, uint64_t sourceHash,
+                      const std::vector<MeshSource>& meshes);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Mesh.h"
+
+/**
+ * @brief Import-time reordering of triangle lists for cheaper rendering.
+ *
+ * Three passes, in this order:
+ *  1. vertex cache: Forsyth's linear-speed ordering, so consecutive
+ *     triangles reuse recently transformed vertices;
+ *  2. overdraw: splits that order into clusters at cache restarts and draws
+ *     outward-facing clusters first, unless that costs more than `threshold`
+ *     in cache efficiency;
+ *  3. vertex fetch: renumbers vertices in first-use order so the vertex
+ *     buffer is read front to back (and drops unreferenced vertices).
+ *
+ * Runs once per asset (the result goes into the mesh cache). No GL here.
+ */
+class MeshOptimizer {
+public:
+    struct Stats {
+        float acmrBefore = 0.0f; // average cache miss ratio: transformed vertices per triangle
+        float acmrAfter = 0.0f;
+    };
+
+    /**
+     * @brief Runs all three passes. `indices` must be a triangle list.
+     */
+    static Stats optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, float threshold = 1.05f);
+
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float threshold);
+    static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+    /**
+     * @brief Cache misses per triangle for a FIFO post-transform cache of `cacheSize` entries.
+     * 3.0 is no reuse at all, around 0.5-0.7 is typical for a well ordered closed mesh.
+     */
+    static float acmr(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize = 16);
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Mesh.h"
+
+// One simplified level of a mesh: new indices into the original vertex array
+struct LodLevel {
+    std::vector<unsigned int> indices;
+    float error = 0.0f; // largest surface deviation, in the mesh's own units
+};
+
+/**
+ * @brief Error-bounded quadric edge-collapse simplification (Garland-Heckbert).
+ *
+ * Collapses move a vertex onto a neighbour (half-edge collapses), so every
+ * level indexes the original vertex array and can share its vertex buffer.
+ * Open borders and attribute seams (several vertices at one position) are
+ * locked so silhouettes and UV islands stay intact. No GL here.
+ */
+class MeshSimplifier {
+public:
+    /**
+     * @brief Collapses edges cheapest first until `targetIndexCount` is reached or the
+     * next collapse would move the surface by more than `maxError`.
+     * @param resultError receives the largest error actually introduced
+     */
+    static std::vector<unsigned int> simplify(const Vertex* vertices, size_t vertexCount, const std::vector<unsigned int>& indices,
+                                              size_t targetIndexCount, float maxError, float& resultError);
+
+    /**
+     * @brief LOD1..N, each with about `reduction` times the triangles of the one before.
+     * Every level is simplified from the full mesh and vertex-cache ordered. The chain
+     * stops early once the error bound (maxRelativeError * bounding box diagonal) stops
+     * further reduction.
+     */
+    static std::vector<LodLevel> buildLodChain(const Vertex* vertices, size_t vertexCount, const std::vector<unsigned int>& indices,
+                                               int maxLevels = 3, float reduction = 0.5f, float maxRelativeError = 0.02f);
+};
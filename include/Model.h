@@ -6,24 +6,128 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshSimplifier.h"
+#include "TextureCache.h"
+#include "RenderQueue.h"
+#include "ResidencyManager.h"
+
+// CPU-side result of importing one aiMesh, before upload
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    glm::vec3 baseColor = glm::vec3(1.0f);
+    AABB bounds;
+    std::vector<TextureRef> textures;
+    std::vector<LodLevel> lods; // simplified index lists over `vertices`
+};
+
+// Compact GPU copy of one mesh, built by Model::Import next to its MeshSource
+struct CompactMeshData {
+    std::vector<PackedVertex> vertices; // empty: upload the source's float vertices
+    std::vector<uint16_t> indices;      // empty: upload the source's 32-bit indices
+    std::vector<std::vector<uint16_t>> lodIndices; // same for each LOD, when `indices` is used
+};
+
+// Everything needed to build a Model without touching GL. Produced by Model::Import on any thread.
+struct ModelData {
+    std::string directory;
+    std::vector<MeshSource> meshes;          // views into `storage` or `mapping`
+    std::vector<MeshData> storage;           // owns the arrays after an Assimp import
+    std::shared_ptr<MappedFile> mapping;     // owns the arrays after a mesh cache hit
+    std::map<std::string, ImageData> images;      // decoded textures by TextureCache key
+    std::map<std::string, TextureHandle> cached;  // textures another model already uploaded
+    std::vector<CompactMeshData> compact;    // one per mesh
+    glm::vec3 positionScale = glm::vec3(1.0f); // dequantization for packed vertices
+    glm::vec3 positionBias = glm::vec3(0.0f);
+    AABB bounds;                             // object-space box around every mesh
+};
 
 class Model {
 public:
-    std::vector<Texture> textures_loaded; // Cache to avoid duplicate loading
     std::vector<Mesh> meshes;
     std::string directory;
 
+    // Packed vertices share one quantization box per model so its meshes still batch
+    glm::vec3 positionScale = glm::vec3(1.0f);
+    glm::vec3 positionBias = glm::vec3(0.0f);
+
+    // Object space, around the meshes uploaded so far (culling and LOD selection). Kept across eviction.
+    AABB bounds;
+
+    // Set by AssetLoader: Submit touches it and sizes are reported on upload/eviction (0 = not tracked)
+    ResidencyId residency = 0;
+    // Import result kept after upload when the loader was asked to (re-uploaded from on restore)
+    std::shared_ptr<const ModelData> cpuData;
+
+    Model() = default; // Empty; filled mesh by mesh (see AssetLoader)
     Model(const std::string& path);
-    void Draw(unsigned int shaderProgram);
+    ~Model();
+
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+    // One multi-draw packet per batch of meshes that share a pool, textures and color
+    void Submit(RenderQueue& queue, Shader& shader, const glm::mat4& transform, int lod = 0) const;
+
+    // CPU half of loading: mesh cache or Assimp import, then texture decoding. No GL calls.
+    static bool Import(const std::string& path, ModelData& data);
+    // GL half: uploads one mesh plus any of its textures that aren't loaded yet
+    void UploadMesh(const ModelData& data, size_t index);
+    // GL thread: frees every mesh (and textures no other model uses). Bounds and LOD errors stay
+    // so the model can still be culled; UploadMesh fills it again.
+    void Evict();
+
+    // CPU copies this model still holds (cpuData, kept mesh arrays) and its geometry in the pools
+    size_t GetCpuBytes() const;
+    size_t GetGpuBytes() const;
+    // Rough heap size of an import result (arrays, compact copies and decoded images)
+    static size_t GetCpuBytes(const ModelData& data);
+
+    int GetBatchCount() const { return static_cast<int>(batches.size()); }
+    // Levels any mesh has; meshes with fewer stay at their coarsest one
+    int GetLodCount() const { return static_cast<int>(lodErrors.size()); }
+    // Largest object-space error over the meshes, per level (for LodSelector)
+    const std::vector<float>& GetLodErrors() const { return lodErrors; }
+
+    // Upload PackedVertex instead of Vertex for models imported from now on (default on)
+    static void SetPackedVertices(bool enabled) { packedVertices.store(enabled); }
+    static bool UsesPackedVertices() { return packedVertices.load(); }
 
 private:
-    void loadModel(const std::string& path);
-    void processNode(aiNode* node, const aiScene* scene);
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-    
-    // Loads textures from material
-    std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName, const aiScene* scene);
+    // Index ranges of one glMultiDrawElementsBaseVertex
+    struct DrawRanges {
+        std::vector<GLsizei> counts;
+        std::vector<const void*> indexOffsets;
+        std::vector<GLint> baseVertices;
+    };
+    // Meshes drawn together, with their ranges at every LOD
+    struct MeshBatch {
+        size_t mesh; // first mesh: material, color and VAO
+        std::vector<size_t> members;
+        std::vector<DrawRanges> lods;
+    };
+    std::vector<MeshBatch> batches; // rebuilt whenever a mesh is uploaded
+    std::vector<float> lodErrors = { 0.0f };
+
+    void buildBatches();
+    void reportResidency() const;
+
+    static std::atomic<bool> packedVertices;
+
+    static void processNode(aiNode* node, const aiScene* scene, std::vector<MeshData>& out);
+    static MeshData processMesh(aiMesh* mesh, const aiScene* scene);
+
+    // Collects texture references from a material
+    static void collectMaterialTextures(aiMaterial *mat, aiTextureType type, const std::string& typeName, const aiScene* scene, std::vector<TextureRef>& out);
+    static void decodeTextures(ModelData& data);
+    static bool computeBounds(ModelData& data); // false if there are no vertices
+    static void compactMeshes(ModelData& data);
+    // Uploads (or reuses) the GL textures for a mesh's references
+    std::vector<Texture> loadTextures(const std::vector<TextureRef>& refs, const ModelData& data);
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <mujoco/mujoco.h>
+#include <memory>
+#include <vector>
+
+#include "Physics.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Many independent copies of one MuJoCo model, stepped in parallel.
+ *
+ * The mjModel is shared read-only (it stays owned by the MujocoSim it came from);
+ * each environment has its own mjData. Batched calls take and return contiguous
+ * arrays laid out environment-major, e.g. ctrl[env * nu + i]. No window or GL
+ * context is needed.
+ */
+class MujocoBatch {
+public:
+    /**
+     * @param sim Source of the model; must outlive the batch
+     * @param numEnvs Number of environments
+     * @param numThreads Worker threads, 0 = one per hardware thread
+     */
+    MujocoBatch(const MujocoSim& sim, int numEnvs, unsigned int numThreads = 0);
+    ~MujocoBatch();
+
+    MujocoBatch(const MujocoBatch&) = delete;
+    MujocoBatch& operator=(const MujocoBatch&) = delete;
+
+    int getNumEnvs() const { return static_cast<int>(data_.size()); }
+    int getNumThreads() const { return pool_ ? static_cast<int>(pool_->size()) + 1 : 1; } // workers + caller
+    int nq() const { return m_->nq; }
+    int nv() const { return m_->nv; }
+    int nu() const { return m_->nu; }
+
+    /**
+     * @brief Applies controls (numEnvs * nu, may be null to keep the current ones),
+     * advances every environment by `substeps` mj_steps and refreshes the
+     * contiguous state arrays returned by getQpos()/getQvel().
+     */
+    void step(const mjtNum* ctrl = nullptr, int substeps = 1);
+
+    /**
+     * @brief Copies controls (numEnvs * nu) into every environment without stepping
+     */
+    void setControls(const mjtNum* ctrl);
+
+    /**
+     * @brief Resets every environment, or only those with mask[env] != 0
+     * @param keyframe Keyframe index to reset to, -1 for the model defaults
+     */
+    void reset(const unsigned char* mask = nullptr, int keyframe = -1);
+
+    /**
+     * @brief Environment-major state after the last step()/reset() (numEnvs * nq / nv)
+     */
+    const mjtNum* getQpos() const { return qpos_.data(); }
+    const mjtNum* getQvel() const { return qvel_.data(); }
+    const mjtNum* getTime() const { return time_.data(); }
+
+    mjData* getData(int env) { return data_[env]; }
+
+    /**
+     * @brief Aggregate environment steps per second of the last step() call
+     */
+    double getStepsPerSecond() const { return stepsPerSecond_; }
+    long long getTotalSteps() const { return totalSteps_; }
+
+private:
+    const mjModel* m_;
+    std::vector<mjData*> data_;
+    std::unique_ptr<ThreadPool> pool_; // null when running single-threaded
+
+    std::vector<mjtNum> qpos_;
+    std::vector<mjtNum> qvel_;
+    std::vector<mjtNum> time_;
+
+    double stepsPerSecond_ = 0.0;
+    long long totalSteps_ = 0;
+
+    void gatherState(int env);
+    void forEachRange(const std::function<void(int, int)>& fn);
+};
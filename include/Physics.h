@@ -20,10 +20,20 @@ public:
 
     /**
      * @brief Load a model file (e.g., Menagerie's spot/scene.xml)
+     *
+     * The compiled model is cached as .mjb under .cache/mujoco, keyed on a hash of
+     * the XML, every included XML and every referenced asset. Later loads with
+     * identical inputs skip parsing and mesh compilation entirely.
+     *
      * @param modelPath Path to the MJCF or URDF file
      */
     void loadModel(const std::string& modelPath);
 
+    /**
+     * @brief Enables/disables the compiled model cache (on by default)
+     */
+    void setUseModelCache(bool use) { useModelCache_ = use; }
+
     /**
      * @brief Steps the simulation by one timestep (m->opt.timestep)
      */
@@ -53,16 +63,54 @@ public:
      */
     void getGeomTransform(int index, float* pos, float* mat) const;
 
+    /**
+     * @brief Bulk export of geom world transforms as GPU-ready column-major mat4s
+     * (16 floats per geom, out[16 * i] holds geom first + i).
+     *
+     * Uses vectorized double->float conversion. Only geoms whose body moved since the
+     * previous export are rewritten, so the caller must keep `out` alive between calls.
+     * Geoms on bodies welded to the world are written once and then cost nothing.
+     * Meant for a single consumer; call invalidatePoses() when switching buffers.
+     *
+     * @param out Destination, at least 16 * count floats
+     * @param first First geom index
+     * @param count Number of geoms, -1 for all remaining
+     * @param changed Optional, receives the ids of the geoms that were rewritten
+     * @return Number of geoms rewritten
+     */
+    int exportGeomPoses(float* out, int first = 0, int count = -1, std::vector<int>* changed = nullptr);
+
+    /**
+     * @brief Forces the next exportGeomPoses to rewrite every geom
+     */
+    void invalidatePoses();
+
+    /**
+     * @brief Motion below this threshold (per component) is not reported as a change
+     */
+    void setPoseEpsilon(double epsilon) { poseEpsilon_ = epsilon; }
+
     /**
      * @brief Access internal MuJoCo pointers (for advanced control)
      */
     mjModel* getModel() { return m_; }
     mjData* getData() { return d_; }
+    const mjModel* getModel() const { return m_; }
+    const mjData* getData() const { return d_; }
 
 private:
     mjModel* m_ = nullptr;
     mjData* d_ = nullptr;
     char error_[1000];
+    bool useModelCache_ = true;
+
+    // Pose export change tracking
+    std::vector<int> dynamicBodies_;        // bodies that can move (not welded to world, or mocap)
+    std::vector<mjtNum> bodyPoseCache_;     // xpos + xquat (7 per body) at the last detected move
+    std::vector<unsigned int> bodyVersion_; // bumped whenever a body moves
+    std::vector<unsigned int> geomVersion_; // body version each geom was last exported at
+    double poseEpsilon_ = 1e-7;
 
     void cleanup();
+    void resetPoseTracking();
 };
\ No newline at end of file
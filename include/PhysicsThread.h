@@ -0,0 +1,126 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Physics.h"
+#include "TripleBuffer.h"
+
+/**
+ * @brief Geom poses published by the physics thread
+ */
+struct PoseSnapshot {
+    std::vector<glm::mat4> geomModels; // every geom, MuJoCo world frame (see exportGeomPoses)
+    std::vector<int> changed;          // geoms that moved since the last snapshot the render thread took
+    double simTime = 0.0;
+    double wallTime = 0.0;             // steady clock seconds at publish
+    uint64_t sequence = 0;
+};
+
+/**
+ * @brief Steps a MujocoSim at its fixed timestep on a dedicated thread.
+ *
+ * Poses are handed to the render thread through a lock-free triple buffer, so
+ * neither side waits on the other. Physics publishes faster than the renderer
+ * polls; the changed list of a snapshot that is replaced before being taken is
+ * carried into the next one, so every snapshot the render thread sees lists
+ * exactly the geoms that moved since the one it saw before. A real-time-factor controller caps how many
+ * steps may run per tick to catch up; time beyond that budget is dropped
+ * instead of being carried over, which avoids the spiral of death.
+ *
+ * While running, the thread owns the sim's mjData: do not touch it elsewhere.
+ */
+class PhysicsThread {
+public:
+    explicit PhysicsThread(MujocoSim& sim);
+    ~PhysicsThread();
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    /**
+     * @brief Simulated seconds per wall-clock second (1.0 = real time)
+     */
+    void setTargetRTF(double rtf) { targetRTF_.store(rtf > 0.0 ? rtf : 0.0); }
+    double getTargetRTF() const { return targetRTF_.load(); }
+
+    /**
+     * @brief Maximum mj_step calls per tick when behind schedule
+     */
+    void setMaxCatchUpSteps(int steps) { maxCatchUpSteps_.store(steps > 0 ? steps : 1); }
+    int getMaxCatchUpSteps() const { return maxCatchUpSteps_.load(); }
+
+    /**
+     * @brief Upper bound on snapshot publishes per second (each one copies all geom poses)
+     */
+    void setPublishRate(double hz) { publishInterval_.store(hz > 0.0 ? 1.0 / hz : 0.0); }
+
+    // Statistics (smoothed over ~0.5 s)
+    double getAchievedRTF() const { return achievedRTF_.load(); }
+    double getStepsPerSecond() const { return stepsPerSecond_.load(); }
+    double getDroppedTime() const { return droppedTime_.load(); } // wall seconds discarded in total
+
+    // --- Render thread side ---
+
+    /**
+     * @brief Takes the newest snapshot if one was published. Never blocks.
+     * @return true if getCurrent() changed
+     */
+    bool poll();
+
+    const PoseSnapshot& getCurrent() const { return current_; }
+    const PoseSnapshot& getPrevious() const { return previous_; }
+
+    /**
+     * @brief True when getCurrent().changed does not cover everything that differs from
+     * getPrevious(): the first snapshot, or the geom count changed
+     */
+    bool hasGap() const { return previous_.geomModels.size() != current_.geomModels.size(); }
+
+    /**
+     * @brief Blend factor between previous and current for a render at wallNow
+     * (steady clock seconds, see now()). Rendering lags physics by one publish.
+     */
+    float getInterpolationAlpha(double wallNow) const;
+
+    /**
+     * @brief Steady clock in seconds, the time base of PoseSnapshot::wallTime
+     */
+    static double now();
+
+private:
+    MujocoSim& sim_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<double> targetRTF_{1.0};
+    std::atomic<int> maxCatchUpSteps_{20};
+    std::atomic<double> publishInterval_{1.0 / 240.0};
+
+    std::atomic<double> achievedRTF_{0.0};
+    std::atomic<double> stepsPerSecond_{0.0};
+    std::atomic<double> droppedTime_{0.0};
+
+    TripleBuffer<PoseSnapshot> buffer_;
+
+    // Physics thread only
+    std::vector<glm::mat4> poses_;
+    std::vector<int> changed_;
+    std::vector<int> carried_;     // changes of snapshots replaced before the render thread took them
+    std::vector<uint8_t> changedMark_;
+    uint64_t sequence_ = 0;
+
+    // Render thread only
+    PoseSnapshot current_;
+    PoseSnapshot previous_;
+
+    void run();
+    void publish(double wallTime);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.h"
+#include "RenderTargetPool.h"
+
+// A float uniform of a pass, exposed to the UI
+struct PostParam {
+    std::string name; // uniform in the pass's snippet
+    float value;
+    float min;
+    float max;
+    UniformId id = -1;
+};
+
+// One step of the post-process chain. Its snippet, <directory>/<name>.glsl, defines
+//   vec3 <name>(vec3 color, vec2 uv)  if pointwise (sees only the color of its own pixel), or
+//   vec3 <name>(vec2 uv)               if it samples its input around the pixel (SampleColor).
+// Both may read depth (SampleDepth) and the other helpers in common.glsl anywhere.
+struct PostPass {
+    std::string name;
+    bool pointwise = true;
+    bool enabled = true;
+    std::vector<PostParam> params;
+};
+
+// What the passes read, and the camera they were rendered with
+struct PostInputs {
+    unsigned int color = 0; // textures
+    unsigned int depth = 0;
+    int width = 0;
+    int height = 0;
+    int viewportWidth = 0;  // part of the textures holding the scene, 0 = all of it
+    int viewportHeight = 0;
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+};
+
+// Post-process chain between the scene framebuffer and the screen.
+// Enabled passes are fused: every pointwise pass is appended to the program of
+// the pass before it, so a chain of them costs one full-screen draw. Only a
+// pass that samples neighbouring pixels starts a new program, reading the
+// previous one's output from a pooled target that goes back to the pool as
+// soon as it has been read, so any chain ping-pongs between two textures.
+// Fused programs are generated from the snippets on first use and cached.
+// Every pass works at the target's resolution: the first one upscales the
+// scene's viewport through SampleColor/SampleDepth (see common.glsl), so the
+// scene may be rendered at any scale without the passes knowing.
+class PostProcessGraph {
+public:
+    PostProcessGraph(const std::string& directory, RenderTargetPool& targets);
+    ~PostProcessGraph();
+
+    PostProcessGraph(const PostProcessGraph&) = delete;
+    PostProcessGraph& operator=(const PostProcessGraph&) = delete;
+
+    // Passes run in the order they are added
+    PostPass& AddPass(const std::string& name, bool pointwise, std::vector<PostParam> params = {}, bool enabled = true);
+    PostPass* GetPass(const std::string& name);
+    std::vector<PostPass>& GetPasses() { return passes; }
+
+    // Runs the enabled passes, the last one into `target` (0 = the window)
+    void Execute(const PostInputs& inputs, unsigned int target, int targetWidth, int targetHeight);
+
+    // Full-screen draws in the last Execute
+    int GetDrawCount() const { return drawCount; }
+
+private:
+    struct Group {
+        std::vector<const PostPass*> passes; // starts with the only non-pointwise pass, if any
+        Shader* program = nullptr;
+    };
+
+    std::string directory;
+    RenderTargetPool& targets;
+    std::string vertexSource;
+    std::string commonSource;
+    std::unordered_map<std::string, std::string> snippets;
+    std::unordered_map<std::string, std::unique_ptr<Shader>> programs; // keyed by pass names
+
+    std::vector<PostPass> passes;
+    std::vector<Group> groups;
+
+    unsigned int emptyVAO = 0;
+    unsigned int linearSampler = 0;
+    int drawCount = 0;
+
+    void BuildGroups();
+    Shader* GetProgram(const std::vector<const PostPass*>& fused);
+    const std::string& GetSnippet(const std::string& name);
+};
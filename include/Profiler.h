@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One finished scope. Names must outlive the profiler (string literals).
+struct ProfileEvent {
+    const char* name;
+    int64_t start;   // ns on Profiler::now()'s clock
+    int64_t end;
+    uint32_t thread; // Profiler thread index, or Profiler::kGpuThread
+    uint32_t depth;  // nesting level within its thread
+};
+
+/**
+ * @brief Scoped CPU and GPU timing with Chrome trace export and an ImGui flame view.
+ *
+ * CPU scopes (PROFILE_SCOPE) are written to a per-thread single-producer ring
+ * without locks; beginFrame() drains every ring on the GL thread. A thread's
+ * ring is handed to the next new thread once it has exited and been drained,
+ * so short-lived pools don't grow the profiler. GPU scopes
+ * (GPU_PROFILE_SCOPE) bracket their commands with GL_TIMESTAMP queries that
+ * are read back kGpuLatency frames later, and only if the results are already
+ * available, so the CPU never waits on the GPU. Events from the last few
+ * seconds are kept for writeChromeTrace (chrome://tracing, Perfetto).
+ */
+class Profiler {
+public:
+    static constexpr uint32_t kGpuThread = 0xFFFFFFFF;
+    static constexpr size_t kRingCapacity = 1 << 14; // events per thread between two beginFrame() calls
+    static constexpr int kGpuLatency = 4;            // frames of GPU queries in flight
+    static constexpr size_t kHistoryEvents = 1 << 18;
+
+    static Profiler& instance();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Steady clock in nanoseconds
+     */
+    static int64_t now();
+
+    /**
+     * @brief Any thread: label for the calling thread in traces and the flame view
+     */
+    static void setThreadName(const char* name);
+
+    static void setEnabled(bool enabled) { enabled_.store(enabled); }
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Used by ProfileScope: returns the depth to pass to endScope
+    static uint32_t beginScope();
+    static void endScope(const char* name, int64_t start, uint32_t depth);
+
+    /**
+     * @brief GL thread, at the top of every frame: collects CPU events and finished GPU queries
+     */
+    void beginFrame();
+
+    // GL thread. Used by GpuProfileScope; nesting is allowed.
+    void beginGpuScope(const char* name);
+    void endGpuScope();
+
+    /**
+     * @brief GL thread, before the context goes away
+     */
+    void shutdownGpu();
+
+    /**
+     * @brief Writes the kept events as Chrome trace JSON
+     */
+    bool writeChromeTrace(const std::string& path) const;
+
+    /**
+     * @brief ImGui window with one row per thread for the last complete frame
+     */
+    void drawWindow(bool* open = nullptr);
+
+    // Statistics
+    uint64_t getDroppedEvents() const { return dropped_.load(); }
+    double getLastFrameMs() const { return (lastFrameEnd_ - lastFrameStart_) * 1e-6; }
+    double getLastGpuFrameMs() const { return lastGpuFrameMs_; }
+
+private:
+    Profiler() = default;
+
+    struct ThreadRing {
+        ProfileEvent events[kRingCapacity];
+        std::atomic<size_t> head{0}; // written by the owning thread only
+        std::atomic<size_t> tail{0}; // written by beginFrame only
+        std::atomic<bool> retired{false}; // owning thread has exited
+        bool free = false;                // retired and drained, for the next new thread (ringMutex_)
+        uint32_t index = 0;
+        uint32_t depth = 0;
+        std::string name;
+    };
+
+    struct GpuQuery {
+        const char* name;
+        unsigned int begin, end;
+        uint32_t depth;
+    };
+    struct GpuFrame {
+        std::vector<GpuQuery> queries;
+        std::vector<unsigned int> pool; // query objects, reused every kGpuLatency frames
+        size_t used = 0;
+        int64_t cpuMinusGpu = 0;        // clock offset measured when the frame was issued
+        int64_t cpuStart = 0;
+    };
+
+    static std::atomic<bool> enabled_;
+
+    mutable std::mutex ringMutex_; // registration, reuse and thread names
+    std::vector<std::unique_ptr<ThreadRing>> rings_; // never shrinks; bounded by the most threads alive at once
+    static ThreadRing& localRing();
+
+    // GL thread only below
+    GpuFrame gpuFrames_[kGpuLatency];
+    uint64_t frameIndex_ = 0;
+    std::vector<size_t> gpuStack_;
+    bool gpuAvailable_ = true;
+
+    mutable std::mutex historyMutex_; // beginFrame vs. writeChromeTrace from another thread
+    std::deque<ProfileEvent> history_;
+    std::vector<ProfileEvent> lastFrame_;    // CPU events of the last complete frame
+    std::vector<ProfileEvent> lastGpuFrame_; // GPU events of the newest frame read back
+    int64_t frameStart_ = 0;
+    int64_t lastFrameStart_ = 0, lastFrameEnd_ = 0;
+    int64_t lastGpuFrameStart_ = 0;
+    double lastGpuFrameMs_ = 0.0;
+    std::atomic<uint64_t> dropped_{0};
+
+    unsigned int acquireQuery(GpuFrame& frame);
+    void collectGpu(GpuFrame& frame);
+    void addEvent(const ProfileEvent& event);
+    std::string threadName(uint32_t thread) const;
+};
+
+/**
+ * @brief Times the enclosing block on the calling thread
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name_(name), enabled_(Profiler::isEnabled()) {
+        if (enabled_) {
+            depth_ = Profiler::beginScope();
+            start_ = Profiler::now();
+        }
+    }
+    ~ProfileScope() {
+        if (enabled_) Profiler::endScope(name_, start_, depth_);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    bool enabled_;
+    uint32_t depth_ = 0;
+    int64_t start_ = 0;
+};
+
+/**
+ * @brief Times the GL commands issued in the enclosing block (GL thread)
+ */
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name) : enabled_(Profiler::isEnabled()) {
+        if (enabled_) Profiler::instance().beginGpuScope(name);
+    }
+    ~GpuProfileScope() {
+        if (enabled_) Profiler::instance().endGpuScope();
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    bool enabled_;
+};
+
+#define TOON_PROFILE_CONCAT_(a, b) a##b
+#define TOON_PROFILE_CONCAT(a, b) TOON_PROFILE_CONCAT_(a, b)
+
+// Define TOON_DISABLE_PROFILER to compile every scope out
+#ifndef TOON_DISABLE_PROFILER
+#define PROFILE_SCOPE(name) ProfileScope TOON_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define GPU_PROFILE_SCOPE(name) GpuProfileScope TOON_PROFILE_CONCAT(gpuProfileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define GPU_PROFILE_SCOPE(name) ((void)0)
+#endif
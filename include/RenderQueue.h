@@ -0,0 +1,98 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+#include "Shader.h"
+#include "UniformBuffers.h"
+
+// Textures bound to units 0..n-1, with the sampler uniform that reads each unit
+struct RenderMaterial {
+    std::vector<unsigned int> textures;
+    std::vector<Uniform<int>> samplers;
+    std::vector<GLenum> targets; // per texture; missing entries are GL_TEXTURE_2D
+
+    GLenum TargetOf(size_t i) const { return i < targets.size() ? targets[i] : GL_TEXTURE_2D; }
+
+    bool SameAs(const RenderMaterial& other) const {
+        if (textures != other.textures || targets != other.targets || samplers.size() != other.samplers.size()) return false;
+        for (size_t i = 0; i < samplers.size(); ++i)
+            if (samplers[i].id != other.samplers[i].id) return false;
+        return true;
+    }
+};
+
+// Highest bits of the sort key: every packet of a pass is drawn before the next pass
+enum RenderPass {
+    PASS_OPAQUE = 0,      // front to back
+    PASS_TRANSPARENT = 1, // back to front
+};
+
+// One draw call plus the state it needs. Pointers must stay valid until Flush.
+struct DrawPacket {
+    uint64_t key = 0;                         // filled by RenderQueue::Add
+    Shader* shader = nullptr;
+    const RenderMaterial* material = nullptr; // null: no textures
+    unsigned int VAO = 0;
+    GLsizei count = 0;                        // indices, or vertices when indexType is 0
+    GLenum indexType = GL_UNSIGNED_INT;       // 0 draws with glDrawArrays
+    GLsizei instanceCount = 1;                // > 1 draws instanced
+    GLsizei firstIndex = 0;                   // offset into the index buffer in indices (first vertex for glDrawArrays)
+    GLint baseVertex = 0;                     // added to every index (pooled geometry)
+
+    // drawCount > 0: one glMultiDrawElementsBaseVertex over these arrays instead (count/firstIndex unused)
+    GLsizei drawCount = 0;
+    const GLsizei* counts = nullptr;
+    const void* const* indexOffsets = nullptr; // byte offsets into the index buffer
+    const GLint* baseVertices = nullptr;
+
+    int object = -1;                          // ObjectUniforms slot, filled by RenderQueue::Add
+};
+
+/**
+ * Collects the frame's draws, sorts them by a packed 64-bit key and submits
+ * them in that order, so program, texture and VAO changes only happen where
+ * the key changes.
+ *
+ * Key layout, high to low bits:
+ *   pass (2) | program (10) | material (16) | VAO (16) | depth (20)
+ * Depth is the view-space distance of the object origin, inverted for
+ * transparent packets. Ids are GL names folded into their fields; a
+ * collision only costs a redundant bind, since Flush compares the real state.
+ */
+class RenderQueue {
+public:
+    RenderQueue();
+
+    // Clears last frame's packets. view/farPlane quantize the depth field.
+    void Begin(const glm::mat4& view, float farPlane);
+
+    // Queues a packet drawn with `object` bound as the ObjectData block
+    void Add(DrawPacket packet, const ObjectUniforms& object, RenderPass pass = PASS_OPAQUE);
+
+    // Sorts, uploads every ObjectData block in one write and issues the draws
+    void Flush(UniformBuffers& uniforms);
+
+    // Statistics for the last Flush
+    int GetPacketCount() const { return lastPackets; }
+    int GetProgramSwitches() const { return programSwitches; }
+    int GetMaterialSwitches() const { return materialSwitches; }
+    int GetVAOSwitches() const { return vaoSwitches; }
+    long long GetTriangleCount() const { return triangles; }
+
+private:
+    std::vector<DrawPacket> packets;
+    std::vector<ObjectUniforms> objects;
+    glm::mat4 view;
+    float farPlane;
+
+    int lastPackets;
+    int programSwitches;
+    int materialSwitches;
+    int vaoSwitches;
+    long long triangles;
+
+    uint64_t makeKey(const DrawPacket& packet, const glm::mat4& model, RenderPass pass) const;
+};
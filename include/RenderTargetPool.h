@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// A pooled 2D texture to render into
+struct RenderTarget {
+    unsigned int texture = 0;
+    int width = 0;
+    int height = 0;
+    GLenum internalFormat = 0;
+    size_t bytes = 0;
+    bool inUse = false;
+    uint64_t lastUsedFrame = 0;
+};
+
+// Transient render targets shared by every pass of a frame.
+// Acquire() hands out a texture of the requested size and format that nobody
+// else holds. Release() ends its lifetime, so a later pass of the same frame
+// gets the same texture back (aliasing) instead of a new allocation. At
+// BeginFrame every target returns to the pool, and ones unused for
+// kMaxIdleFrames are deleted (e.g. the old size after a resize). Framebuffers
+// are cached per attachment pair.
+class RenderTargetPool {
+public:
+    static constexpr uint64_t kMaxIdleFrames = 60;
+
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    void BeginFrame();
+
+    // GL_DEPTH_COMPONENT* formats give depth targets (nearest, white border), anything else color (linear, clamped)
+    RenderTarget* Acquire(int width, int height, GLenum internalFormat);
+    void Release(RenderTarget* target);
+
+    // Framebuffer with these attachments (either may be null), created on first use
+    unsigned int GetFramebuffer(const RenderTarget* color, const RenderTarget* depth);
+
+    // Statistics
+    int GetTargetCount() const { return static_cast<int>(targets.size()); }
+    int GetFramebufferCount() const { return static_cast<int>(framebuffers.size()); }
+    size_t GetBytes() const { return totalBytes; }
+    uint64_t GetAllocations() const { return allocations; }
+
+private:
+    std::vector<std::unique_ptr<RenderTarget>> targets;
+    std::unordered_map<uint64_t, unsigned int> framebuffers; // color texture << 32 | depth texture -> FBO
+    uint64_t frame = 0;
+    size_t totalBytes = 0;
+    uint64_t allocations = 0;
+
+    void Destroy(RenderTarget& target);
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using ResidencyId = uint32_t; // 0 = not tracked
+
+/**
+ * @brief Tracks the CPU and GPU bytes of loaded assets and keeps the GPU side under a budget.
+ *
+ * Assets report their sizes with setBytes() and are touched whenever they
+ * are drawn. update() runs once per frame on the GL thread: while tracked
+ * geometry plus resident textures exceed the budget it evicts the least
+ * recently drawn assets, and assets drawn while evicted are restored through
+ * their callbacks. Textures are shared between models, so they are counted
+ * once through TextureCache and freed with the last model that uses them.
+ */
+class ResidencyManager {
+public:
+    enum class State { Loading, Resident, Evicted };
+
+    static ResidencyManager& instance();
+
+    ResidencyManager(const ResidencyManager&) = delete;
+    ResidencyManager& operator=(const ResidencyManager&) = delete;
+
+    /**
+     * @brief Starts tracking an asset in the Loading state. Any thread.
+     * @param evict GL thread: drops the asset's GPU data (empty: never evicted)
+     * @param restore GL thread: starts loading it again after it was drawn while evicted
+     */
+    ResidencyId track(const std::string& name, std::function<void()> evict, std::function<void()> restore);
+
+    /**
+     * @brief Stops tracking (the asset is gone). Any thread.
+     */
+    void untrack(ResidencyId id);
+
+    /**
+     * @brief Current CPU-side and GPU-side size of an asset. Any thread.
+     */
+    void setBytes(ResidencyId id, size_t cpuBytes, size_t gpuBytes);
+
+    /**
+     * @brief Loading finished: the asset may be evicted from now on. Any thread.
+     */
+    void markResident(ResidencyId id);
+
+    /**
+     * @brief GL thread: the asset is drawn this frame. Evicted assets are queued for restore.
+     */
+    void touch(ResidencyId id);
+
+    /**
+     * @brief GL thread, once per frame: restores assets drawn while evicted, then evicts the
+     * least recently drawn ones (idle for at least kMinIdleFrames) until under budget.
+     * @return number of assets evicted
+     */
+    int update();
+
+    // GPU budget in bytes for tracked assets plus textures, 0 = unlimited
+    void setBudget(size_t bytes) { budget_.store(bytes); }
+    size_t getBudget() const { return budget_.load(); }
+
+    // Assets drawn within this many frames are never evicted (keeps a turning camera from thrashing)
+    static constexpr uint64_t kMinIdleFrames = 120;
+
+    // Statistics
+    size_t getCpuBytes() const { return cpuBytes_.load(); }
+    size_t getGpuBytes() const; // tracked assets + TextureCache
+    size_t getAssetCount() const;
+    size_t getResidentCount() const;
+    uint64_t getEvictions() const { return evictions_.load(); }
+    uint64_t getRestores() const { return restores_.load(); }
+
+private:
+    ResidencyManager() = default;
+
+    struct Entry {
+        ResidencyId id;
+        std::string name;
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        State state = State::Loading;
+        uint64_t lastUsed = 0; // frame of the last touch
+        bool wanted = false;   // touched while evicted
+        std::function<void()> evict;
+        std::function<void()> restore;
+    };
+
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_; // most recently touched first
+    std::unordered_map<ResidencyId, std::list<Entry>::iterator> index_;
+    ResidencyId nextId_ = 1;
+    uint64_t frame_ = 0;
+
+    std::atomic<size_t> budget_{1024ull * 1024 * 1024};
+    std::atomic<size_t> cpuBytes_{0};
+    std::atomic<size_t> gpuBytes_{0}; // tracked assets only
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> restores_{0};
+};
@@ -3,6 +3,18 @@
 #include <vector>
 #include <memory> 
 #include "Shader.h"
+#include "Model.h"
+#include "RenderQueue.h"
+#include "LodSelector.h"
+#include "DynamicBvh.h"
+
+// A model placed in the world. Models may still be loading (see AssetLoader).
+struct SceneObject {
+    std::shared_ptr<Model> model;
+    glm::mat4 transform;
+    int lod = -1; // level drawn last frame (hysteresis), -1 before the first
+    int proxy = -1; // culling tree leaf, created once the model has bounds
+};
 
 class Scene {
 public:
@@ -10,8 +22,20 @@ public:
     ~Scene();
 
     void Update(float deltaTime); // <--- NEW: Step physics
-    void Draw(Shader* shader);
+    // Queues the ground and every model whose world bounds touch the frustum
+    void Submit(RenderQueue& queue, Shader* shader, const LodView& lodView, const Frustum& frustum);
     void Clear();
 
+    void AddModel(std::shared_ptr<Model> model, const glm::mat4& transform);
+
+    // Models drawn/culled by the last Submit
+    int GetVisibleCount() const { return visibleCount; }
+    int GetCulledCount() const { return culledCount; }
+
 private:
+    std::vector<SceneObject> objects;
+    DynamicBvh bvh;
+    std::vector<int> visible;
+    int visibleCount = 0;
+    int culledCount = 0;
 };
\ No newline at end of file
@@ -7,6 +7,17 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+
+// Small integer per uniform name, shared by every Shader (see Shader::uniformId)
+using UniformId = int;
+
+// Typed, pre-resolved uniform handle. Create once (e.g. as a static) and pass to Shader::set.
+template <typename T>
+struct Uniform {
+    UniformId id;
+    explicit Uniform(const std::string& name);
+};
 
 class Shader {
 public:
@@ -14,10 +25,27 @@ public:
 
     // Modified Constructor: Takes only ONE file path now
     Shader(const std::string& filePath);
+    // From generated GLSL (e.g. fused post-process passes); `name` labels compile errors
+    Shader(const std::string& vertexSource, const std::string& fragmentSource, const std::string& name);
 
     void use();
 
-    // Uniform setters
+    // Interns a uniform name. Any thread; not meant for the hot path.
+    static UniformId uniformId(const std::string& name);
+
+    // Location of an interned uniform in this program, -1 if inactive. A plain indexed lookup.
+    int location(UniformId id) const { return id < (int)locations.size() ? locations[id] : -1; }
+
+    // Hot-path setters: no string hashing, no allocation
+    void set(Uniform<bool> uniform, bool value) const { glUniform1i(location(uniform.id), (int)value); }
+    void set(Uniform<int> uniform, int value) const { glUniform1i(location(uniform.id), value); }
+    void set(Uniform<float> uniform, float value) const { glUniform1f(location(uniform.id), value); }
+    void set(Uniform<glm::vec2> uniform, const glm::vec2& value) const { glUniform2fv(location(uniform.id), 1, &value[0]); }
+    void set(Uniform<glm::vec3> uniform, const glm::vec3& value) const { glUniform3fv(location(uniform.id), 1, &value[0]); }
+    void set(Uniform<glm::vec4> uniform, const glm::vec4& value) const { glUniform4fv(location(uniform.id), 1, &value[0]); }
+    void set(Uniform<glm::mat4> uniform, const glm::mat4& value) const { glUniformMatrix4fv(location(uniform.id), 1, GL_FALSE, &value[0][0]); }
+
+    // Uniform setters (by name: fine for setup code, use Uniform handles per frame/draw)
     void setBool(const std::string &name, bool value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
@@ -26,5 +54,14 @@ public:
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
 
 private:
+    std::vector<int> locations; // UniformId -> location, filled by reflectUniforms
+
+    std::string name;
+
+    void compile(const std::string& vertexCode, const std::string& fragmentCode);
     void checkCompileErrors(unsigned int shader, std::string type);
-};
\ No newline at end of file
+    void reflectUniforms();
+};
+
+template <typename T>
+Uniform<T>::Uniform(const std::string& name) : id(Shader::uniformId(name)) {}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureContainer.h"
+
+// A GL texture owned by the TextureCache
+struct CachedTexture {
+    unsigned int id = 0;
+    int width = 0;
+    int height = 0;
+    size_t bytes = 0; // GPU size of all mip levels
+    bool compressed = false;
+    std::string key;
+};
+
+using TextureHandle = std::shared_ptr<const CachedTexture>;
+
+/**
+ * @brief Process-wide GL texture cache shared by every Model.
+ *
+ * Textures are keyed on their resolved file path, or on a content hash for
+ * embedded ('*N') textures, so two models referencing the same image share
+ * one upload. Handles are reference-counted: when the last one is dropped
+ * the texture is queued for deletion and freed by the next collect() on the
+ * GL thread (handles may be released on any thread).
+ */
+class TextureCache {
+public:
+    static TextureCache& instance();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * @brief Cache key for a material texture reference. Any thread.
+     */
+    static std::string keyFor(const std::string& path, const std::string& directory,
+                              const unsigned char* embeddedData, size_t embeddedSize);
+
+    /**
+     * @brief Loads an image file through its baked container (.ttex), baking it on a miss. Any thread.
+     * @param flip flip rows on load (external files, to match aiProcess_FlipUVs)
+     */
+    static ImageData loadFile(const std::string& filename, bool flip);
+
+    /**
+     * @brief Same as loadFile for an encoded (PNG/JPG) image held in memory
+     */
+    static ImageData loadEmbedded(const unsigned char* data, size_t size, bool flip);
+
+    /**
+     * @brief Returns the container for `name` if it was baked from `sourceHash`;
+     * otherwise calls `produce`, bakes the pixels and writes the container. Any thread.
+     */
+    static ImageData loadBaked(const std::string& name, uint64_t sourceHash, const std::function<RawImage()>& produce);
+
+    /**
+     * @brief GL thread, once after context creation: enables BC1/BC3 baking if S3TC is available
+     */
+    void initialize();
+    static bool isCompressionEnabled() { return compression_.load(); }
+    static void setCompressionEnabled(bool enabled) { compression_.store(enabled); }
+
+    /**
+     * @brief Live texture for `key`, or null. Any thread; lets loaders skip decoding.
+     */
+    TextureHandle find(const std::string& key);
+
+    /**
+     * @brief GL thread: returns the cached texture for `key`, uploading `image` on a miss
+     */
+    TextureHandle acquire(const std::string& key, const ImageData& image);
+
+    /**
+     * @brief GL thread: deletes textures whose last handle was released. Call once per frame.
+     */
+    void collect();
+
+    // Statistics
+    size_t getTextureCount() const;
+    size_t getResidentBytes() const { return residentBytes_.load(); }
+    uint64_t getHits() const { return hits_.load(); }
+    uint64_t getMisses() const { return misses_.load(); }
+
+private:
+    TextureCache() = default;
+    ~TextureCache();
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::weak_ptr<const CachedTexture>> textures_;
+
+    std::mutex releaseMutex_; // never held together with mutex_
+    std::vector<unsigned int> released_;
+
+    std::atomic<size_t> residentBytes_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+
+    static std::atomic<bool> compression_;
+
+    static unsigned int upload(const ImageData& image);
+    void release(const CachedTexture* texture);
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class TextureFormat : uint32_t {
+    R8 = 1,
+    RGB8 = 2,
+    RGBA8 = 3,
+    BC1 = 4, // DXT1, opaque RGB, 8 bytes per 4x4 block
+    BC3 = 5, // DXT5, RGBA, 16 bytes per 4x4 block
+};
+
+// Pixels straight from a decoder: rows top to bottom, 1, 3 or 4 channels of 8 bits
+struct RawImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::shared_ptr<unsigned char> pixels;
+};
+
+struct TextureLevel {
+    int width = 0;
+    int height = 0;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+};
+
+// Upload-ready texture: the full mip chain, raw or block-compressed
+struct ImageData {
+    TextureFormat format = TextureFormat::RGBA8;
+    int width = 0;
+    int height = 0;
+    std::vector<TextureLevel> levels;    // level 0 first
+    std::shared_ptr<const void> storage; // owns the level bytes (heap block or mapped .ttex)
+
+    bool empty() const { return levels.empty(); }
+    size_t bytes() const;
+};
+
+/**
+ * @brief Baked texture files (.ttex under .cache/textures).
+ *
+ * A container holds every mip level in the exact layout glTexImage2D /
+ * glCompressedTexImage2D expect, so loading is a memory map plus one upload
+ * call per level: no image decoding and no glGenerateMipmap. Files are keyed
+ * on a hash of the source bytes and are rebuilt when it changes. No GL here;
+ * the TextureBaker tool links this file too.
+ */
+class TextureContainer {
+public:
+    // Bump when the layout, the mip filter or the encoder changes
+    static constexpr uint32_t kVersion = 1;
+
+    /**
+     * @brief Container location for a resolved source path or a generated-texture name
+     */
+    static std::string pathFor(const std::string& name);
+
+    /**
+     * @brief Hashes a source file together with the decode settings that change its pixels
+     */
+    static bool hashSource(const std::string& filename, bool flip, uint64_t& hash);
+
+    /**
+     * @brief Builds the mip chain (2x2 box filter) and optionally compresses
+     * 3/4-channel images to BC1/BC3. Single-channel images stay R8.
+     */
+    static ImageData bake(const RawImage& image, bool compress);
+
+    /**
+     * @brief Maps `path`; `image` levels point into the mapping
+     * @return false if missing, corrupt or baked from a different source
+     */
+    static bool read(const std::string& path, uint64_t sourceHash, ImageData& image);
+
+    static bool write(const std::string& path, uint64_t sourceHash, const ImageData& image);
+
+    static bool isCompressed(TextureFormat format) { return format == TextureFormat::BC1 || format == TextureFormat::BC3; }
+    static size_t levelSize(TextureFormat format, int width, int height);
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads fed from a single task queue.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threadCount Number of workers, 0 = one per hardware thread
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int size() const { return static_cast<unsigned int>(workers_.size()); }
+
+    /**
+     * @brief Queues a task to run on any worker
+     */
+    void enqueue(std::function<void()> task);
+
+    /**
+     * @brief Blocks until the queue is empty and no task is running
+     */
+    void wait();
+
+    /**
+     * @brief Splits [0, count) into one contiguous chunk per worker and calls
+     * fn(begin, end) for each. The calling thread runs a chunk too and the call
+     * returns once all chunks are done.
+     */
+    void parallelFor(int count, const std::function<void(int, int)>& fn);
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskReady_;
+    std::condition_variable idle_;
+    int active_ = 0;
+    bool stopping_ = false;
+
+    void workerLoop();
+};
@@ -6,6 +6,11 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <memory> 
+#include <string>
+#include <vector>
+
+#include "AppConfig.h"
+#include "HeadlessContext.h"
 
 #include "Camera.h"
 #include "FrameBuffer.h" // Ensure casing matches disk
@@ -13,38 +18,75 @@
 #include "Model.h"
 #include "Scene.h"
 #include "Physics.h"
+#include "GeomRenderer.h"
+#include "PhysicsThread.h"
+#include "AssetLoader.h"
+#include "UniformBuffers.h"
+#include "RenderQueue.h"
+#include "LodSelector.h"
+#include "ResidencyManager.h"
+#include "Profiler.h"
+#include "FrameStats.h"
+#include "FrameCapture.h"
+#include "PostProcessGraph.h"
+#include "RenderTargetPool.h"
+#include "DynamicResolution.h"
 
 class ToonApp {
 public:
-    ToonApp(int width, int height, const char* title);
+    explicit ToonApp(const AppConfig& config);
     ~ToonApp();
 
     void Run();
 
 private:
-    GLFWwindow* window;
+    AppConfig config;
+    GLFWwindow* window = nullptr; // null when headless
     int scrWidth;
     int scrHeight;
     
     // Safety Flag
     bool isInitialized; // <--- NEW
 
+    // Scene targets come from the pool at the render size, which follows the
+    // window once it has stopped changing for kResizeDebounce seconds
+    static constexpr double kResizeDebounce = 0.2;
+    int renderWidth;
+    int renderHeight;
+    int pendingWidth = 0;
+    int pendingHeight = 0;
+    double pendingSince = 0.0;
+
     // Engine Systems
     std::unique_ptr<Camera> camera;
+    std::unique_ptr<RenderTargetPool> renderTargets;
     std::unique_ptr<FrameBuffer> gameBuffer;
+    DynamicResolution dynamicResolution; // scale of the scene pass within gameBuffer
     
     // Assets
     std::shared_ptr<Shader> regularShader;
-    std::shared_ptr<Shader> postProcessShader;
+    std::shared_ptr<Shader> geomShader;
     std::shared_ptr<Model> backpackModel; 
 
     std::unique_ptr<Scene> activeScene;
     std::unique_ptr<MujocoSim> mujocoSim;
+    std::unique_ptr<GeomRenderer> geomRenderer;
+    std::unique_ptr<UniformBuffers> uniformBuffers; // FrameData / ObjectData blocks
+    std::unique_ptr<RenderQueue> renderQueue;
+    std::unique_ptr<PostProcessGraph> postProcess;
+    std::unique_ptr<PhysicsThread> physicsThread; // declared after mujocoSim: stops first
+    std::unique_ptr<AssetLoader> assetLoader;
+    float uploadBudgetMs = 2.0f; // per-frame GL upload time for streamed assets
+    bool showProfiler = false;   // flame view of the last frame (see Profiler)
+    int vramBudgetMB = 1024;     // models + textures before the least recently drawn are evicted, 0 = no limit
+    LodView lodView;             // camera part refreshed every frame; error budget from the UI
 
     // State
     glm::vec3 lightPos;
     glm::vec3 lightColor;
     glm::vec3 bgColor;
+    float nearPlane = 0.1f; // scene projection; the post passes linearize depth with it
+    float farPlane = 100.0f;
     
     float debugScale;
     float debugRotSpeed;
@@ -53,14 +95,34 @@ private:
     float lastX, lastY;
     bool firstMouse;
     bool mouseCaptured;
-    float deltaTime;
-    float lastFrame;
+    float deltaTime = 0.0f;
+
+    // Frame timing
+    FrameStats frameStats;
+    std::vector<float> frameTimes; // plot scratch
+    int statsWindowFrames = 3600;
+
+    // Recording (F9): asynchronous readback of the presented frames
+    FrameCapture frameCapture;
+    bool captureDepth = false;
+    bool captureRaw = false;
+
+    // Headless output: the post pass renders here instead of the window
+    std::unique_ptr<HeadlessContext> headlessContext;
+    unsigned int outputFbo = 0;
+    unsigned int outputColor = 0;
+    double simulatedTime = 0.0; // frame clock the sim is stepped to
 
     void InitGLFW();
+    void InitHeadless();
     void InitImGui();
+    void RunHeadless();
+    void ToggleCapture();
     void ProcessInput();
     void Update();
+    void UpdateRenderSize();
     void RenderScene();
+    void RenderPostProcess(unsigned int target);
     void RenderUI();
 
     static void framebuffer_size_callback(GLFWwindow* window, int width, int height);
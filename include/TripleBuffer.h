@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free single-producer / single-consumer triple buffer.
+ *
+ * The producer always owns one slot and the consumer another; the third sits in
+ * the middle. Publishing and fetching are single atomic exchanges on the middle
+ * index, so neither side ever blocks or sees a half-written value.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle_(1), back_(2), front_(0) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Producer: the slot to fill before calling publish()
+     */
+    T& writeBuffer() { return slots_[back_]; }
+
+    /**
+     * @brief Producer: hands the write slot to the consumer
+     * @return true if the value published before it was replaced without being fetched;
+     *         writeBuffer() is then that value's slot
+     */
+    bool publish() {
+        uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+        return (previous & kFresh) != 0;
+    }
+
+    /**
+     * @brief Consumer: takes the newest published slot if there is one
+     * @return true if readBuffer() now holds a newer value
+     */
+    bool fetch() {
+        if (!(middle_.load(std::memory_order_acquire) & kFresh)) return false;
+        uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        return true;
+    }
+
+    /**
+     * @brief Consumer: the slot returned by the last successful fetch()
+     */
+    T& readBuffer() { return slots_[front_]; }
+    const T& readBuffer() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T slots_[3];
+    std::atomic<uint8_t> middle_;
+    uint8_t back_;  // producer only
+    uint8_t front_; // consumer only
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Binding points shared by every program (set in Shader::reflectUniforms; GLSL 410 has no layout(binding))
+enum UniformBlockBinding {
+    FRAME_BLOCK_BINDING = 0,  // "FrameData"
+    OBJECT_BLOCK_BINDING = 1, // "ObjectData"
+};
+
+// std140 mirror of FrameData in shaders/uniforms.glsl: written once per frame
+struct FrameUniforms {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::mat4 viewProjection;
+    glm::vec4 viewPos;    // xyz
+    glm::vec4 lightPos;   // xyz
+    glm::vec4 lightColor; // rgb
+};
+
+// std140 mirror of ObjectData in shaders/uniforms.glsl: one slot per draw
+struct ObjectUniforms {
+    glm::mat4 model;
+    glm::mat4 normalMatrix; // inverse-transpose of model, upper 3x3 used
+    glm::vec4 baseColor;    // rgb, fallback when there is no texture
+    glm::vec4 positionScale; // xyz: dequantizes packed positions (1 for float vertices)
+    glm::vec4 positionBias;  // xyz
+    int hasTexture;
+    int padding[3];
+};
+
+class UniformBuffers {
+public:
+    UniformBuffers(int objectCapacity = 4096);
+    ~UniformBuffers();
+
+    UniformBuffers(const UniformBuffers&) = delete;
+    UniformBuffers& operator=(const UniformBuffers&) = delete;
+
+    // Uploads the per-frame block and rewinds the per-draw ring. Call once at the start of a frame.
+    void BeginFrame(const FrameUniforms& frame);
+
+    // Writes one per-draw block and binds it to OBJECT_BLOCK_BINDING for the next draw
+    void PushObject(const ObjectUniforms& object);
+
+    // Convenience: fills normalMatrix from model
+    void PushObject(const glm::mat4& model, const glm::vec3& baseColor, bool hasTexture);
+
+    // Writes `count` consecutive per-draw blocks with one upload; returns the slot of the first
+    int WriteObjects(const ObjectUniforms* objects, int count);
+
+    // Binds a slot returned by WriteObjects (plus an offset < count) to OBJECT_BLOCK_BINDING
+    void BindObject(int slot);
+
+    static ObjectUniforms MakeObject(const glm::mat4& model, const glm::vec3& baseColor, bool hasTexture);
+
+    const FrameUniforms& GetFrame() const { return frame; }
+    int GetObjectCount() const { return objectCount; } // pushes since BeginFrame
+
+private:
+    unsigned int frameUBO, objectUBO;
+    FrameUniforms frame;
+    GLsizeiptr objectStride; // sizeof(ObjectUniforms) rounded up to the offset alignment
+    int objectCapacity;
+    int objectCursor;
+    int objectCount;
+    std::vector<unsigned char> staging; // objects at objectStride, for WriteObjects
+};
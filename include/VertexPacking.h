@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+/**
+ * @brief Conversions from Vertex / 32-bit indices to the compact GPU formats.
+ *
+ * Positions are quantized to unorm16 inside a bounding box and rebuilt in the
+ * vertex shader as `aPos * positionScale + positionBias`; normals go to
+ * snorm 10:10:10:2 and UVs to half floats. No GL here: runs on loader threads.
+ */
+class VertexPacking {
+public:
+    // position = unorm * scale + bias maps [0, 1] onto [boundsMin, boundsMax]
+    static void quantization(const glm::vec3& boundsMin, const glm::vec3& boundsMax, glm::vec3& scale, glm::vec3& bias);
+
+    static PackedVertex pack(const Vertex& vertex, const glm::vec3& scale, const glm::vec3& bias);
+
+    static uint16_t toHalf(float value);
+    static uint32_t packNormal(const glm::vec3& normal);
+
+    /**
+     * @brief True if every index of a mesh with `vertexCount` vertices fits in 16 bits
+     */
+    static bool fitsShortIndices(size_t vertexCount) { return vertexCount <= 65536; }
+
+    static std::vector<uint16_t> shortIndices(const unsigned int* indices, size_t count);
+};
@@ -0,0 +1,71 @@
+#shader vertex
+#version 410 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in int aInstance; // index into the instance buffers (instances are bucketed by LOD)
+
+uniform samplerBuffer instanceModels;  // 4 texels per instance: model matrix columns
+uniform samplerBuffer instanceStatics; // 2 texels per instance: scale, color
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec4 Color;
+
+#include "uniforms.glsl"
+
+void main() {
+    int base = aInstance * 4;
+    mat4 instanceModel = mat4(texelFetch(instanceModels, base),
+                              texelFetch(instanceModels, base + 1),
+                              texelFetch(instanceModels, base + 2),
+                              texelFetch(instanceModels, base + 3));
+    vec4 instanceScale = texelFetch(instanceStatics, aInstance * 2);
+
+    mat4 model = object.model * instanceModel; // object.model: MuJoCo Z-up to engine Y-up
+    vec3 position = aPos * object.positionScale.xyz + object.positionBias.xyz; // packed, per group
+    FragPos = vec3(model * vec4(position * instanceScale.xyz, 1.0));
+
+    // Instance matrices are rigid, so the inverse-transpose of the scaled
+    // model is just the rotation applied to normal / scale (no per-vertex inverse)
+    Normal = mat3(model) * (aNormal / instanceScale.xyz);
+    Color = texelFetch(instanceStatics, aInstance * 2 + 1);
+
+    gl_Position = frame.viewProjection * vec4(FragPos, 1.0);
+}
+
+#shader fragment
+#version 410 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec4 Color;
+
+#include "uniforms.glsl"
+
+void main() {
+    vec3 lightPos = frame.lightPos.xyz;
+    vec3 viewPos = frame.viewPos.xyz;
+    vec3 lightColor = frame.lightColor.rgb;
+
+    // Ambient
+    float ambientStrength = 0.1;
+    vec3 ambient = ambientStrength * lightColor;
+
+    // Diffuse
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // Specular
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    vec3 result = (ambient + diffuse + specular) * Color.rgb;
+    FragColor = vec4(result, 1.0);
+}
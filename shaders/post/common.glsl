@@ -0,0 +1,30 @@
+// Inputs of every generated post-process program (see PostProcessGraph)
+uniform sampler2D screenTexture; // color written by the previous group (the scene for the first)
+uniform sampler2D depthTexture;  // scene depth
+uniform vec2 colorScale;         // output uv to screenTexture uv (the scene may fill only part of it)
+uniform vec2 colorMax;           // last screenTexture uv inside that part
+uniform vec2 depthScale;         // the same for depthTexture
+uniform vec2 depthMax;
+uniform vec2 outputTexelSize;    // 1 / output size in pixels
+uniform vec2 cameraPlanes;       // near, far of the scene projection
+
+// Everything takes output uv, so offsets in outputTexelSize are screen pixels
+// whatever resolution the scene was rendered at
+vec3 SampleColor(vec2 uv) {
+    return texture(screenTexture, min(max(uv, vec2(0.0)) * colorScale, colorMax)).rgb;
+}
+
+float SampleDepth(vec2 uv) {
+    return texture(depthTexture, min(max(uv, vec2(0.0)) * depthScale, depthMax)).r;
+}
+
+// Non-linear depth (0 - 1) to view distance
+float LinearizeDepth(float depth) {
+    float z = depth * 2.0 - 1.0;
+    return (2.0 * cameraPlanes.x * cameraPlanes.y) / (cameraPlanes.y + cameraPlanes.x - z * (cameraPlanes.y - cameraPlanes.x));
+}
+
+vec4 LinearizeDepth(vec4 depth) {
+    vec4 z = depth * 2.0 - 1.0;
+    return (2.0 * cameraPlanes.x * cameraPlanes.y) / (cameraPlanes.y + cameraPlanes.x - z * (cameraPlanes.y - cameraPlanes.x));
+}
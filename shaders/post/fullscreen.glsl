@@ -0,0 +1,9 @@
+#version 410 core
+out vec2 TexCoords;
+
+void main() {
+    // One triangle covering the screen, no vertex buffer: ids 0, 1, 2 -> (0,0), (2,0), (0,2)
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoords = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
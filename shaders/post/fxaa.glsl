@@ -0,0 +1,31 @@
+// FXAA-style smoothing: blends along the local luma edge. Samples its input
+// around the pixel, so it cannot be fused with the passes before it.
+uniform float fxaaStrength;
+
+float fxaaLuma(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+vec3 fxaa(vec2 uv) {
+    vec3 rgbM = SampleColor(uv);
+    float lumaNW = fxaaLuma(SampleColor(uv + vec2(-1.0, -1.0) * outputTexelSize));
+    float lumaNE = fxaaLuma(SampleColor(uv + vec2( 1.0, -1.0) * outputTexelSize));
+    float lumaSW = fxaaLuma(SampleColor(uv + vec2(-1.0,  1.0) * outputTexelSize));
+    float lumaSE = fxaaLuma(SampleColor(uv + vec2( 1.0,  1.0) * outputTexelSize));
+    float lumaM = fxaaLuma(rgbM);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.03125, 1.0 / 128.0);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-8.0), vec2(8.0)) * outputTexelSize;
+
+    vec3 rgbA = 0.5 * (SampleColor(uv + dir * (1.0 / 3.0 - 0.5)) +
+                       SampleColor(uv + dir * (2.0 / 3.0 - 0.5)));
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (SampleColor(uv - dir * 0.5) +
+                                     SampleColor(uv + dir * 0.5));
+    float lumaB = fxaaLuma(rgbB);
+    vec3 result = (lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB;
+    return mix(rgbM, result, fxaaStrength);
+}
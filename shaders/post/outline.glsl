@@ -0,0 +1,18 @@
+// Black lines where the view distance jumps. Five depth taps (the pixel and a
+// cross outlineWidth pixels out); the four neighbours are linearized together.
+// The cross is measured in output pixels, so lines keep their width at any render scale.
+uniform float outlineWidth;     // output pixels
+uniform float outlineThreshold; // Laplacian of distance, relative to the pixel's distance
+
+vec3 outline(vec3 color, vec2 uv) {
+    vec2 dx = vec2(outputTexelSize.x * outlineWidth, 0.0);
+    vec2 dy = vec2(0.0, outputTexelSize.y * outlineWidth);
+
+    float center = LinearizeDepth(SampleDepth(uv));
+    vec4 neighbours = LinearizeDepth(vec4(SampleDepth(uv - dx), SampleDepth(uv + dx),
+                                          SampleDepth(uv - dy), SampleDepth(uv + dy)));
+
+    // Relative, so the line holds up at any distance without catching sloped surfaces
+    float laplacian = dot(neighbours, vec4(1.0)) - 4.0 * center;
+    return abs(laplacian) > outlineThreshold * center ? vec3(0.0) : color;
+}
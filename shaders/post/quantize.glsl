@@ -0,0 +1,6 @@
+// Flat color bands
+uniform float quantizeLevels;
+
+vec3 quantize(vec3 color, vec2 uv) {
+    return floor(color * quantizeLevels) / quantizeLevels;
+}
@@ -8,16 +8,15 @@ out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "uniforms.glsl"
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    vec3 position = aPos * object.positionScale.xyz + object.positionBias.xyz; // identity for float vertices
+    FragPos = vec3(object.model * vec4(position, 1.0));
+    Normal = mat3(object.normalMatrix) * aNormal;  
     TexCoords = aTexCoords;
     
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    gl_Position = frame.viewProjection * vec4(FragPos, 1.0);
 }
 
 #shader fragment
@@ -28,14 +27,14 @@ in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform vec3 objectColor;
+#include "uniforms.glsl"
 uniform sampler2D texture_diffuse1;
-uniform bool hasTexture;
 
 void main() {
+    vec3 lightPos = frame.lightPos.xyz;
+    vec3 viewPos = frame.viewPos.xyz;
+    vec3 lightColor = frame.lightColor.rgb;
+
     // Ambient
     float ambientStrength = 0.1;
     vec3 ambient = ambientStrength * lightColor;
@@ -53,7 +52,7 @@ void main() {
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
     vec3 specular = specularStrength * spec * lightColor;  
         
-    vec3 textureColor = hasTexture ? texture(texture_diffuse1, TexCoords).rgb : objectColor;
+    vec3 textureColor = object.hasTexture != 0 ? texture(texture_diffuse1, TexCoords).rgb : object.baseColor.rgb;
     vec3 result = (ambient + diffuse + specular) * textureColor;
     FragColor = vec4(result, 1.0);
 }
\ No newline at end of file
@@ -8,15 +8,14 @@ out vec3 Normal;
 out vec3 FragPos;
 out vec2 TexCoords;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "uniforms.glsl"
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal; 
+    vec3 position = aPos * object.positionScale.xyz + object.positionBias.xyz; // identity for float vertices
+    FragPos = vec3(object.model * vec4(position, 1.0));
+    Normal = mat3(object.normalMatrix) * aNormal; 
     TexCoords = aTexCoords;
-    gl_Position = projection * view * vec4(FragPos, 1.0);
+    gl_Position = frame.viewProjection * vec4(FragPos, 1.0);
 }
 
 #shader fragment
@@ -27,12 +26,13 @@ in vec3 Normal;
 in vec3 FragPos;
 in vec2 TexCoords;
 
-uniform vec3 lightPos;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
+#include "uniforms.glsl"
 uniform sampler2D texture_diffuse1; 
 
 void main() {
+    vec3 lightPos = frame.lightPos.xyz;
+    vec3 lightColor = frame.lightColor.rgb;
+
     // 1. Texture & Alpha Test
     vec4 texColor = texture(texture_diffuse1, TexCoords);
     
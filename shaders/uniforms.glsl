@@ -0,0 +1,20 @@
+// Shared uniform blocks, pulled in with #include "uniforms.glsl".
+// Layouts mirror FrameUniforms / ObjectUniforms in include/UniformBuffers.h.
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    mat4 viewProjection;
+    vec4 viewPos;    // xyz
+    vec4 lightPos;   // xyz
+    vec4 lightColor; // rgb
+} frame;
+
+layout (std140) uniform ObjectData {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 baseColor;
+    vec4 positionScale; // packed vertices: position = aPos * scale + bias
+    vec4 positionBias;
+    int hasTexture;
+} object;
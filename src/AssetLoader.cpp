@@ -0,0 +1,117 @@
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+AssetLoader::AssetLoader(unsigned int threadCount) {
+    if (threadCount == 0)
+        threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    pool_ = std::make_unique<ThreadPool>(threadCount);
+    self_ = std::make_shared<AssetLoader*>(this);
+}
+
+AssetLoader::~AssetLoader() {
+    // Imports that haven't started are skipped; running ones finish but queue nothing
+    cancelled_.store(true);
+    pool_.reset();
+
+    // Unrun GL jobs only hold CPU data, dropping them is safe
+    std::lock_guard<std::mutex> lock(uploadMutex_);
+    uploads_.clear();
+}
+
+std::shared_ptr<Model> AssetLoader::loadModel(const std::string& path, bool keepCpuData) {
+    auto model = std::make_shared<Model>();
+    model->directory = path.substr(0, path.find_last_of('/'));
+
+    std::weak_ptr<Model> weakModel = model;
+    std::weak_ptr<AssetLoader*> weakLoader = self_;
+    model->residency = ResidencyManager::instance().track(path,
+        [weakModel] {
+            if (auto evicted = weakModel.lock()) evicted->Evict();
+        },
+        [weakModel, weakLoader, path, keepCpuData] {
+            auto restored = weakModel.lock();
+            auto loader = weakLoader.lock();
+            if (restored && loader) (*loader)->startImport(restored, path, keepCpuData);
+        });
+
+    startImport(model, path, keepCpuData);
+    return model;
+}
+
+void AssetLoader::startImport(const std::shared_ptr<Model>& model, const std::string& path, bool keepCpuData) {
+    // Uploads the meshes one job at a time, then hands the model over to the residency manager
+    auto queueMeshes = [this, model, keepCpuData](const std::shared_ptr<const ModelData>& data) {
+        for (size_t i = 0; i < data->meshes.size(); ++i) {
+            if (cancelled_.load()) return;
+            queueUpload([model, data, i] { model->UploadMesh(*data, i); });
+        }
+        queueUpload([model, data, keepCpuData] {
+            // Without keepCpuData the import result dies with the last job holding it
+            if (keepCpuData) model->cpuData = data;
+            ResidencyManager& residency = ResidencyManager::instance();
+            residency.setBytes(model->residency, model->GetCpuBytes(), model->GetGpuBytes());
+            residency.markResident(model->residency);
+        });
+    };
+
+    // Restoring a model that kept its data: nothing to import
+    if (model->cpuData) {
+        queueMeshes(model->cpuData);
+        return;
+    }
+
+    pendingImports_.fetch_add(1);
+    pool_->enqueue([this, path, queueMeshes] {
+        if (!cancelled_.load()) {
+            PROFILE_SCOPE("Import Model");
+            auto data = std::make_shared<ModelData>();
+            auto start = std::chrono::steady_clock::now();
+
+            if (Model::Import(path, *data)) {
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                std::cout << "Imported " << path << " (" << data->meshes.size() << " meshes, "
+                          << (data->mapping ? "mesh cache" : "assimp") << ") in " << ms << " ms" << std::endl;
+            } else {
+                data->meshes.clear();
+            }
+            // One job per mesh keeps each slice of GL work small
+            queueMeshes(data);
+        }
+        pendingImports_.fetch_sub(1);
+    });
+}
+
+void AssetLoader::queueUpload(std::function<void()> job) {
+    std::lock_guard<std::mutex> lock(uploadMutex_);
+    uploads_.push_back(std::move(job));
+}
+
+size_t AssetLoader::getPendingUploads() const {
+    std::lock_guard<std::mutex> lock(uploadMutex_);
+    return uploads_.size();
+}
+
+int AssetLoader::update(double budgetMs) {
+    using clock = std::chrono::steady_clock;
+    auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(budgetMs));
+
+    int jobs = 0;
+    do {
+        std::function<void()> job;
+        {
+            std::lock_guard<std::mutex> lock(uploadMutex_);
+            if (uploads_.empty()) break;
+            job = std::move(uploads_.front());
+            uploads_.pop_front();
+        }
+        PROFILE_SCOPE("Upload Job");
+        job(); // outside the lock so workers can keep queueing
+        ++jobs;
+    } while (clock::now() < deadline);
+
+    return jobs;
+}
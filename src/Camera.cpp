@@ -72,6 +72,16 @@ void Camera::ProcessMouseScroll(float yoffset) {
         Zoom = 45.0f;
 }
 
+void Camera::LookAt(const glm::vec3& target) {
+    glm::vec3 direction = target - Position;
+    if (glm::length(direction) < 0.0001f) return;
+    direction = glm::normalize(direction);
+
+    Yaw = glm::degrees(std::atan2(direction.z, direction.x));
+    Pitch = glm::clamp(glm::degrees(std::asin(direction.y)), -89.0f, 89.0f);
+    updateCameraVectors();
+}
+
 void Camera::updateCameraVectors() {
     glm::vec3 front;
     front.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
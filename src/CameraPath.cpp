@@ -0,0 +1,107 @@
+#include "CameraPath.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t) {
+    float t2 = t * t;
+    float t3 = t2 * t;
+    return 0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+}
+
+} // namespace
+
+bool CameraPath::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "ERROR::CAMERAPATH::FILE_NOT_FOUND " << path << std::endl;
+        return false;
+    }
+
+    std::vector<CameraKey> loaded;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream in(line);
+
+        CameraKey key;
+        if (!(in >> key.time)) continue; // blank or comment
+        if (!(in >> key.position.x >> key.position.y >> key.position.z >> key.target.x >> key.target.y >> key.target.z)) {
+            std::cout << "ERROR::CAMERAPATH::BAD_KEY " << path << ":" << lineNumber << std::endl;
+            return false;
+        }
+        if (!(in >> key.zoom)) key.zoom = ZOOM;
+        if (!loaded.empty() && key.time < loaded.back().time) {
+            std::cout << "ERROR::CAMERAPATH::KEYS_OUT_OF_ORDER " << path << ":" << lineNumber << std::endl;
+            return false;
+        }
+        loaded.push_back(key);
+    }
+
+    if (loaded.empty()) {
+        std::cout << "ERROR::CAMERAPATH::NO_KEYS " << path << std::endl;
+        return false;
+    }
+    keys = std::move(loaded);
+    return true;
+}
+
+CameraPath CameraPath::Orbit(const glm::vec3& center, float radius, float height, float period) {
+    // Eight keys per turn are plenty for the spline to read as a circle
+    const int steps = 8;
+    CameraPath path;
+    for (int i = 0; i <= steps; ++i) {
+        float angle = glm::two_pi<float>() * i / steps;
+        CameraKey key;
+        key.time = period * i / steps;
+        key.position = center + glm::vec3(radius * std::sin(angle), height, radius * std::cos(angle));
+        key.target = center;
+        key.zoom = ZOOM;
+        path.AddKey(key);
+    }
+    return path;
+}
+
+void CameraPath::Apply(Camera& camera, float time) const {
+    if (keys.empty()) return;
+
+    glm::vec3 position, target;
+    float zoom;
+    if (keys.size() == 1 || time <= keys.front().time) {
+        position = keys.front().position;
+        target = keys.front().target;
+        zoom = keys.front().zoom;
+    } else if (time >= keys.back().time) {
+        position = keys.back().position;
+        target = keys.back().target;
+        zoom = keys.back().zoom;
+    } else {
+        // Segment [i, i + 1] containing time; the end keys double as their own neighbours
+        size_t i = std::upper_bound(keys.begin(), keys.end(), time,
+                                    [](float t, const CameraKey& key) { return t < key.time; }) - keys.begin() - 1;
+        const CameraKey& k0 = keys[i > 0 ? i - 1 : i];
+        const CameraKey& k1 = keys[i];
+        const CameraKey& k2 = keys[i + 1];
+        const CameraKey& k3 = keys[i + 2 < keys.size() ? i + 2 : i + 1];
+
+        float span = k2.time - k1.time;
+        float t = span > 0.0f ? (time - k1.time) / span : 0.0f;
+        position = catmullRom(k0.position, k1.position, k2.position, k3.position, t);
+        target = catmullRom(k0.target, k1.target, k2.target, k3.target, t);
+        zoom = k1.zoom + (k2.zoom - k1.zoom) * t;
+    }
+
+    camera.Position = position;
+    camera.Zoom = zoom;
+    camera.LookAt(target);
+}
@@ -0,0 +1,244 @@
+#include "DynamicBvh.h"
+
+#include <algorithm>
+
+DynamicBvh::DynamicBvh(float margin)
+    : root(-1), freeList(-1), proxyCount(0), margin(margin), lastNodesTested(0) {
+}
+
+void DynamicBvh::Clear() {
+    nodes.clear();
+    root = -1;
+    freeList = -1;
+    proxyCount = 0;
+}
+
+int DynamicBvh::allocateNode() {
+    int node;
+    if (freeList >= 0) {
+        node = freeList;
+        freeList = nodes[node].parent;
+    } else {
+        node = static_cast<int>(nodes.size());
+        nodes.push_back(Node());
+    }
+    Node& n = nodes[node];
+    n.box = AABB();
+    n.parent = n.child1 = n.child2 = -1;
+    n.height = 0;
+    n.userData = -1;
+    return node;
+}
+
+void DynamicBvh::freeNode(int node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+int DynamicBvh::CreateProxy(const AABB& box, int userData) {
+    int proxy = allocateNode();
+    nodes[proxy].box = AABB(box.min - glm::vec3(margin), box.max + glm::vec3(margin));
+    nodes[proxy].userData = userData;
+    insertLeaf(proxy);
+    ++proxyCount;
+    return proxy;
+}
+
+void DynamicBvh::DestroyProxy(int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --proxyCount;
+}
+
+bool DynamicBvh::MoveProxy(int proxy, const AABB& box) {
+    if (nodes[proxy].box.Contains(box)) return false;
+
+    removeLeaf(proxy);
+    nodes[proxy].box = AABB(box.min - glm::vec3(margin), box.max + glm::vec3(margin));
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicBvh::insertLeaf(int leaf) {
+    if (root < 0) {
+        root = leaf;
+        nodes[root].parent = -1;
+        return;
+    }
+
+    // 1. Walk down to the sibling whose box grows least (surface area heuristic)
+    AABB leafBox = nodes[leaf].box;
+    int index = root;
+    while (!nodes[index].IsLeaf()) {
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+
+        float area = nodes[index].box.GetSurfaceArea();
+        float combinedArea = AABB::Union(nodes[index].box, leafBox).GetSurfaceArea();
+
+        // Making a new parent here, vs. pushing the leaf further down (which grows this node anyway)
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            AABB grown = AABB::Union(leafBox, nodes[child].box);
+            if (nodes[child].IsLeaf()) return grown.GetSurfaceArea() + inheritanceCost;
+            return grown.GetSurfaceArea() - nodes[child].box.GetSurfaceArea() + inheritanceCost;
+        };
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? child1 : child2;
+    }
+    int sibling = index;
+
+    // 2. New parent for the sibling and the leaf
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = AABB::Union(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent >= 0) {
+        if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+        else nodes[oldParent].child2 = newParent;
+    } else {
+        root = newParent;
+    }
+
+    // 3. Refit and rebalance up to the root
+    index = nodes[leaf].parent;
+    while (index >= 0) {
+        index = balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        nodes[index].box = AABB::Union(nodes[child1].box, nodes[child2].box);
+        index = nodes[index].parent;
+    }
+}
+
+void DynamicBvh::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    // The leaf's parent goes away; its other child takes the parent's place
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent < 0) {
+        root = sibling;
+        nodes[sibling].parent = -1;
+        freeNode(parent);
+        return;
+    }
+
+    if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+    else nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int index = grandParent;
+    while (index >= 0) {
+        index = balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].box = AABB::Union(nodes[child1].box, nodes[child2].box);
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        index = nodes[index].parent;
+    }
+}
+
+// Rotates the taller child up if the subtree at `a` is out of balance. Returns the subtree's new root.
+int DynamicBvh::balance(int a) {
+    Node& A = nodes[a];
+    if (A.IsLeaf() || A.height < 2) return a;
+
+    int b = A.child1;
+    int c = A.child2;
+    int balanceFactor = nodes[c].height - nodes[b].height;
+    if (balanceFactor >= -1 && balanceFactor <= 1) return a;
+
+    // The taller child (up) replaces `a`; `a` takes the up node's shorter child (down)
+    int up = balanceFactor > 1 ? c : b;
+    int other = balanceFactor > 1 ? b : c;
+    int f = nodes[up].child1;
+    int g = nodes[up].child2;
+
+    nodes[up].child1 = a;
+    nodes[up].parent = A.parent;
+    A.parent = up;
+
+    if (nodes[up].parent >= 0) {
+        Node& upParent = nodes[nodes[up].parent];
+        if (upParent.child1 == a) upParent.child1 = up;
+        else upParent.child2 = up;
+    } else {
+        root = up;
+    }
+
+    int keep = nodes[f].height > nodes[g].height ? f : g;
+    int down = keep == f ? g : f;
+    nodes[up].child2 = keep;
+    if (balanceFactor > 1) A.child2 = down;
+    else A.child1 = down;
+    nodes[down].parent = a;
+
+    A.box = AABB::Union(nodes[other].box, nodes[down].box);
+    nodes[up].box = AABB::Union(A.box, nodes[keep].box);
+    A.height = 1 + std::max(nodes[other].height, nodes[down].height);
+    nodes[up].height = 1 + std::max(A.height, nodes[keep].height);
+    return up;
+}
+
+void DynamicBvh::collectLeaves(int node, std::vector<int>& userData) const {
+    // Whole subtree inside the frustum: no more plane tests
+    size_t base = stack.size();
+    stack.push_back(node);
+    while (stack.size() > base) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& n = nodes[index];
+        if (n.IsLeaf()) {
+            userData.push_back(n.userData);
+        } else {
+            stack.push_back(n.child1);
+            stack.push_back(n.child2);
+        }
+    }
+}
+
+void DynamicBvh::Query(const Frustum& frustum, std::vector<int>& userData) const {
+    lastNodesTested = 0;
+    if (root < 0) return;
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& n = nodes[index];
+
+        ++lastNodesTested;
+        FrustumTest result = frustum.Test(n.box);
+        if (result == FRUSTUM_OUTSIDE) continue;
+
+        if (n.IsLeaf()) {
+            userData.push_back(n.userData);
+        } else if (result == FRUSTUM_INSIDE) {
+            collectLeaves(index, userData);
+        } else {
+            stack.push_back(n.child1);
+            stack.push_back(n.child2);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include "DynamicResolution.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kHeadroom = 0.9;    // aim below the target so ordinary jitter stays inside it
+constexpr double kSmoothing = 0.15;  // weight of a new reading
+constexpr float kDeadband = 0.02f;   // smaller corrections are ignored
+constexpr float kMaxDrop = 0.1f;     // per reading
+constexpr float kMaxRaise = 0.02f;
+
+} // namespace
+
+DynamicResolution::~DynamicResolution() {
+    shutdownGpu();
+}
+
+void DynamicResolution::setScaleRange(float minScale, float maxScale) {
+    minScale_ = std::clamp(minScale, 0.1f, 1.0f);
+    maxScale_ = std::clamp(maxScale, minScale_, 1.0f);
+    scale_ = std::clamp(scale_, minScale_, maxScale_);
+}
+
+void DynamicResolution::beginFrame() {
+    if (!queries_[0]) glGenQueries(kLatency, queries_);
+
+    // The slot about to be reused was issued kLatency frames ago; older ones are read as they finish
+    for (int i = 0; i < kLatency; ++i) {
+        if (!pending_[i]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(queries_[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries_[i], GL_QUERY_RESULT, &ns);
+        pending_[i] = false;
+        adjust(ns * 1e-6);
+    }
+
+    int slot = static_cast<int>(frame_ % kLatency);
+    if (pending_[slot]) {
+        active_ = false; // still not back after kLatency frames: skip timing this frame rather than wait
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries_[slot]);
+    active_ = true;
+}
+
+void DynamicResolution::endFrame() {
+    if (active_) {
+        glEndQuery(GL_TIME_ELAPSED);
+        pending_[frame_ % kLatency] = true;
+        active_ = false;
+    }
+    ++frame_;
+}
+
+void DynamicResolution::adjust(double gpuMs) {
+    filteredMs_ = filteredMs_ > 0.0 ? filteredMs_ + (gpuMs - filteredMs_) * kSmoothing : gpuMs;
+    if (!enabled_ || filteredMs_ <= 0.0) return;
+
+    float desired = scale_ * static_cast<float>(std::sqrt(kHeadroom * targetMs_ / filteredMs_));
+    desired = std::clamp(desired, minScale_, maxScale_);
+    if (std::abs(desired - scale_) < kDeadband) return;
+
+    // Drop fast to catch up with a heavy view, come back slowly so it does not oscillate
+    scale_ = std::clamp(desired, scale_ - kMaxDrop, scale_ + kMaxRaise);
+}
+
+void DynamicResolution::shutdownGpu() {
+    if (!queries_[0]) return;
+    if (active_) glEndQuery(GL_TIME_ELAPSED);
+    glDeleteQueries(kLatency, queries_);
+    std::fill(queries_, queries_ + kLatency, 0u);
+    std::fill(pending_, pending_ + kLatency, false);
+    active_ = false;
+}
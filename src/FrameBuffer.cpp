@@ -1,121 +1,35 @@
 #include "FrameBuffer.h"
-#include <iostream>
 
-FrameBuffer::FrameBuffer(int scrWidth, int scrHeight) 
-    : width(scrWidth), height(scrHeight) 
-{
-    setupScreenQuad();
-    setupFramebuffer();
-}
+#include <algorithm>
+#include <cmath>
+
+FrameBuffer::FrameBuffer(RenderTargetPool& pool) : pool(pool) {}
 
 FrameBuffer::~FrameBuffer() {
-    glDeleteFramebuffers(1, &fbo);
-    glDeleteTextures(1, &texID);
-    glDeleteTextures(1, &depthTexID); // Changed from glDeleteRenderbuffers
-    glDeleteVertexArrays(1, &rectVAO);
-    glDeleteBuffers(1, &rectVBO);
+    Release();
 }
 
-void FrameBuffer::Resize(int newWidth, int newHeight) {
+void FrameBuffer::Bind(int newWidth, int newHeight, float scale) {
+    Release();
     width = newWidth;
     height = newHeight;
-    
-    // Resize Color Texture
-    glBindTexture(GL_TEXTURE_2D, texID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    scale = std::clamp(scale, 0.0f, 1.0f);
+    viewportWidth = std::max(1, static_cast<int>(std::lround(width * scale)));
+    viewportHeight = std::max(1, static_cast<int>(std::lround(height * scale)));
 
-    // Resize Depth Texture
-    glBindTexture(GL_TEXTURE_2D, depthTexID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
+    // Same size as last frame: the pool returns the same textures and cached FBO
+    color = pool.Acquire(width, height, GL_RGBA8);
+    depth = pool.Acquire(width, height, GL_DEPTH_COMPONENT24);
+    fbo = pool.GetFramebuffer(color, depth);
 
-void FrameBuffer::Bind() {
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, viewportWidth, viewportHeight);
     glEnable(GL_DEPTH_TEST);
 }
 
-void FrameBuffer::DrawToScreen(Shader& postProcessShader) {
-    // 1. Switch back to default buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); 
-    glDisable(GL_DEPTH_TEST); 
-    
-    // 2. Clear default buffer
-    glClearColor(1.0f, 1.0f, 1.0f, 1.0f); 
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    // 3. Draw Quad
-    postProcessShader.use();
-    
-    // Bind Color to Unit 0
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texID);
-    postProcessShader.setInt("screenTexture", 0);
-
-    // Bind Depth to Unit 1
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, depthTexID);
-    postProcessShader.setInt("depthTexture", 1);
-
-    glBindVertexArray(rectVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+void FrameBuffer::Release() {
+    pool.Release(color);
+    pool.Release(depth);
+    color = depth = nullptr;
+    fbo = 0;
 }
-
-void FrameBuffer::setupFramebuffer() {
-    glGenFramebuffers(1, &fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-
-    // 1. Color Attachment Texture
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    // glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    // glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texID, 0);
-
-    // 2. Depth Attachment Texture (Replaces RBO)
-    glGenTextures(1, &depthTexID);
-    glBindTexture(GL_TEXTURE_2D, depthTexID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER); 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    // Set border color to white (far plane) so we don't get edges at screen borders
-    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexID, 0);
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
-        
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
-void FrameBuffer::setupScreenQuad() {
-    float quadVertices[] = { 
-        // positions   // texCoords
-        -1.0f,  1.0f,  0.0f, 1.0f,
-        -1.0f, -1.0f,  0.0f, 0.0f,
-         1.0f, -1.0f,  1.0f, 0.0f,
-
-        -1.0f,  1.0f,  0.0f, 1.0f,
-         1.0f, -1.0f,  1.0f, 0.0f,
-         1.0f,  1.0f,  1.0f, 1.0f
-    };
-
-    glGenVertexArrays(1, &rectVAO);
-    glGenBuffers(1, &rectVBO);
-    glBindVertexArray(rectVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, rectVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-    
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-}
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "FrameCapture.h"
+#include "Profiler.h"
+
+#include <glad/glad.h>
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+bool FrameCapture::start(const Settings& settings) {
+    if (recording_) stop();
+
+    std::error_code error;
+    std::filesystem::create_directories(settings.outputDir, error);
+    if (error) {
+        std::cout << "ERROR::CAPTURE::CREATE_DIRECTORY_FAILED " << settings.outputDir << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    settings_ = settings;
+    settings_.ringSize = std::max(settings_.ringSize, 1);
+    settings_.maxQueuedFrames = std::max<size_t>(settings_.maxQueuedFrames, 1);
+
+    if (settings_.format == Format::Raw) {
+        std::string colorPath = (std::filesystem::path(settings_.outputDir) / "color.rgb").string();
+        colorStream_ = std::fopen(colorPath.c_str(), "wb");
+        if (!colorStream_) {
+            std::cout << "ERROR::CAPTURE::OPEN_FAILED " << colorPath << std::endl;
+            return false;
+        }
+        if (settings_.captureDepth) {
+            std::string depthPath = (std::filesystem::path(settings_.outputDir) / "depth.f32").string();
+            depthStream_ = std::fopen(depthPath.c_str(), "wb");
+            if (!depthStream_) std::cout << "ERROR::CAPTURE::OPEN_FAILED " << depthPath << std::endl;
+        }
+        streamWidth_ = streamHeight_ = 0;
+        streamDepthWidth_ = streamDepthHeight_ = 0;
+    }
+
+    slots_.assign(static_cast<size_t>(settings_.ringSize), Slot());
+    for (Slot& slot : slots_) {
+        glGenBuffers(1, &slot.colorPbo);
+        glGenBuffers(1, &slot.depthPbo);
+    }
+    head_ = inFlight_ = 0;
+    captured_ = stalls_ = 0;
+    written_ = 0;
+    dropped_ = 0;
+
+    // A raw stream has to stay in order: one writer
+    writers_ = std::make_unique<ThreadPool>(settings_.format == Format::Raw ? 1u : std::max(settings_.pngThreads, 1u));
+    recording_ = true;
+    return true;
+}
+
+void FrameCapture::stop() {
+    if (!recording_) return;
+
+    // Everything already captured gets written; waiting on the GPU is fine here
+    settings_.dropWhenBehind = false;
+    while (inFlight_ > 0) {
+        Slot& slot = slots_[(head_ + slots_.size() - inFlight_) % slots_.size()];
+        glClientWaitSync(static_cast<GLsync>(slot.fence), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        collect(slot);
+    }
+    writers_.reset(); // drains the queue
+
+    for (Slot& slot : slots_) {
+        glDeleteBuffers(1, &slot.colorPbo);
+        glDeleteBuffers(1, &slot.depthPbo);
+    }
+    slots_.clear();
+
+    if (colorStream_) {
+        std::fclose(colorStream_);
+        colorStream_ = nullptr;
+        std::cout << "Capture: " << written_.load() << " frames in " << settings_.outputDir << "/color.rgb, encode with\n"
+                  << "  ffmpeg -f rawvideo -pixel_format rgb24 -video_size " << streamWidth_ << "x" << streamHeight_
+                  << " -framerate " << settings_.fps << " -i color.rgb capture.mp4" << std::endl;
+    }
+    if (depthStream_) {
+        std::fclose(depthStream_);
+        depthStream_ = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        pool_.clear();
+    }
+    recording_ = false;
+}
+
+void FrameCapture::capture(unsigned int colorFbo, int width, int height, unsigned int depthFbo, int depthWidth, int depthHeight) {
+    if (!recording_ || width <= 0 || height <= 0) return;
+    PROFILE_SCOPE("Frame Capture");
+    int64_t start = Profiler::now();
+
+    poll();
+    if (inFlight_ == slots_.size()) {
+        // The GPU is more than ringSize frames behind: wait for the oldest readback rather than drop it
+        Slot& oldest = slots_[(head_ + slots_.size() - inFlight_) % slots_.size()];
+        glClientWaitSync(static_cast<GLsync>(oldest.fence), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        collect(oldest);
+        ++stalls_;
+    }
+
+    Slot& slot = slots_[head_];
+    slot.width = width;
+    slot.height = height;
+    slot.depthWidth = depthWidth;
+    slot.depthHeight = depthHeight;
+    slot.depth = settings_.captureDepth && depthWidth > 0 && depthHeight > 0;
+    slot.index = captured_++;
+
+    // Copies into the PBO on the GPU; glReadPixels returns without waiting for the frame
+    size_t colorBytes = static_cast<size_t>(width) * height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.colorPbo);
+    if (slot.colorBytes != colorBytes) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, colorBytes, nullptr, GL_STREAM_READ);
+        slot.colorBytes = colorBytes;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, colorFbo);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    if (slot.depth) {
+        size_t depthBytes = static_cast<size_t>(depthWidth) * depthHeight * sizeof(float);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.depthPbo);
+        if (slot.depthBytes != depthBytes) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, depthBytes, nullptr, GL_STREAM_READ);
+            slot.depthBytes = depthBytes;
+        }
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, depthFbo);
+        glReadPixels(0, 0, depthWidth, depthHeight, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    head_ = (head_ + 1) % slots_.size();
+    ++inFlight_;
+
+    lastCpuMs_ = (Profiler::now() - start) * 1e-6;
+}
+
+void FrameCapture::poll() {
+    // Oldest first: fences signal in submission order
+    while (inFlight_ > 0) {
+        Slot& slot = slots_[(head_ + slots_.size() - inFlight_) % slots_.size()];
+        GLenum status = glClientWaitSync(static_cast<GLsync>(slot.fence), GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        collect(slot);
+    }
+}
+
+void FrameCapture::collect(Slot& slot) {
+    glDeleteSync(static_cast<GLsync>(slot.fence));
+    slot.fence = nullptr;
+    --inFlight_;
+
+    // Nowhere to put it: skip the copy as well
+    if (settings_.dropWhenBehind && queued_.load() >= settings_.maxQueuedFrames) {
+        ++dropped_;
+        return;
+    }
+
+    std::unique_ptr<Frame> frame = acquireFrame();
+    frame->index = slot.index;
+    frame->width = slot.width;
+    frame->height = slot.height;
+    frame->depthWidth = slot.depthWidth;
+    frame->depthHeight = slot.depthHeight;
+
+    // The data is already in client-visible memory, so mapping does not wait
+    size_t colorBytes = static_cast<size_t>(slot.width) * slot.height * 4;
+    frame->color.resize(colorBytes);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.colorPbo);
+    if (const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, colorBytes, GL_MAP_READ_BIT)) {
+        std::memcpy(frame->color.data(), data, colorBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    frame->depth.clear();
+    if (slot.depth) {
+        size_t depthCount = static_cast<size_t>(slot.depthWidth) * slot.depthHeight;
+        frame->depth.resize(depthCount);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.depthPbo);
+        if (const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, depthCount * sizeof(float), GL_MAP_READ_BIT)) {
+            std::memcpy(frame->depth.data(), data, depthCount * sizeof(float));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    submit(std::move(frame));
+}
+
+void FrameCapture::submit(std::unique_ptr<Frame> frame) {
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        queueSpace_.wait(lock, [this] { return queued_.load() < settings_.maxQueuedFrames; });
+        ++queued_;
+    }
+
+    // std::function needs a copyable callable; the task owns the frame from here
+    Frame* raw = frame.release();
+    writers_->enqueue([this, raw] {
+        std::unique_ptr<Frame> owned(raw);
+        write(*owned);
+        releaseFrame(std::move(owned));
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            --queued_;
+        }
+        queueSpace_.notify_all();
+    });
+}
+
+void FrameCapture::write(Frame& frame) {
+    PROFILE_SCOPE("Write Capture");
+
+    // RGBA bottom-up -> RGB top-down; alpha of the presented image is meaningless
+    thread_local std::vector<unsigned char> rgb;
+    rgb.resize(static_cast<size_t>(frame.width) * frame.height * 3);
+    for (int y = 0; y < frame.height; ++y) {
+        const unsigned char* src = frame.color.data() + static_cast<size_t>(frame.height - 1 - y) * frame.width * 4;
+        unsigned char* dst = rgb.data() + static_cast<size_t>(y) * frame.width * 3;
+        for (int x = 0; x < frame.width; ++x) {
+            dst[x * 3 + 0] = src[x * 4 + 0];
+            dst[x * 3 + 1] = src[x * 4 + 1];
+            dst[x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+    if (!frame.depth.empty()) {
+        for (int y = 0; y < frame.depthHeight / 2; ++y)
+            std::swap_ranges(frame.depth.begin() + static_cast<size_t>(y) * frame.depthWidth,
+                             frame.depth.begin() + static_cast<size_t>(y + 1) * frame.depthWidth,
+                             frame.depth.begin() + static_cast<size_t>(frame.depthHeight - 1 - y) * frame.depthWidth);
+    }
+
+    bool ok = true;
+    if (settings_.format == Format::Png) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%05llu.png", (unsigned long long)frame.index);
+        std::string path = (std::filesystem::path(settings_.outputDir) / name).string();
+        ok = stbi_write_png(path.c_str(), frame.width, frame.height, 3, rgb.data(), frame.width * 3) != 0;
+
+        if (ok && !frame.depth.empty()) {
+            std::snprintf(name, sizeof(name), "depth_%05llu.f32", (unsigned long long)frame.index);
+            path = (std::filesystem::path(settings_.outputDir) / name).string();
+            FILE* file = std::fopen(path.c_str(), "wb");
+            ok = file && std::fwrite(frame.depth.data(), sizeof(float), frame.depth.size(), file) == frame.depth.size();
+            if (file) std::fclose(file);
+        }
+    } else {
+        // A stream has one size; frames after a resize are dropped
+        if (streamWidth_ == 0) {
+            streamWidth_ = frame.width;
+            streamHeight_ = frame.height;
+            streamDepthWidth_ = frame.depthWidth;
+            streamDepthHeight_ = frame.depthHeight;
+        }
+        if (frame.width != streamWidth_ || frame.height != streamHeight_ ||
+            (!frame.depth.empty() && (frame.depthWidth != streamDepthWidth_ || frame.depthHeight != streamDepthHeight_))) {
+            ++dropped_;
+            return;
+        }
+        ok = std::fwrite(rgb.data(), 1, rgb.size(), colorStream_) == rgb.size();
+        if (ok && depthStream_)
+            ok = std::fwrite(frame.depth.data(), sizeof(float), frame.depth.size(), depthStream_) == frame.depth.size();
+    }
+
+    if (ok) {
+        ++written_;
+    } else {
+        ++dropped_;
+        std::cout << "ERROR::CAPTURE::WRITE_FAILED frame " << frame.index << std::endl;
+    }
+}
+
+std::unique_ptr<FrameCapture::Frame> FrameCapture::acquireFrame() {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    if (pool_.empty()) return std::make_unique<Frame>();
+    std::unique_ptr<Frame> frame = std::move(pool_.back());
+    pool_.pop_back();
+    return frame;
+}
+
+void FrameCapture::releaseFrame(std::unique_ptr<Frame> frame) {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    pool_.push_back(std::move(frame));
+}
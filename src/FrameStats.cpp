@@ -0,0 +1,171 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cstdio>
+
+FrameStats::FrameStats(size_t window)
+    : capacity_(std::max<size_t>(window, 1)) {
+    ring_.resize(capacity_);
+    histogram_.assign(static_cast<size_t>(kHistogramMs / kBucketMs) + 1, 0);
+}
+
+size_t FrameStats::bucketOf(float ms) {
+    size_t overflow = static_cast<size_t>(kHistogramMs / kBucketMs);
+    if (!(ms > 0.0f)) return 0;
+    return std::min(static_cast<size_t>(ms / kBucketMs), overflow);
+}
+
+double FrameStats::tick(float gpuMs) {
+    Clock::time_point now = Clock::now();
+    if (!started_) {
+        start_ = last_ = now;
+        started_ = true;
+        return 0.0;
+    }
+    double seconds = std::chrono::duration<double>(now - last_).count();
+    last_ = now;
+
+    FrameSample sample;
+    sample.index = frameIndex_++;
+    sample.time = std::chrono::duration<double>(now - start_).count();
+    sample.frameMs = static_cast<float>(seconds * 1000.0);
+    sample.gpuMs = gpuMs;
+
+    // Against the window before this frame, so one long frame can't raise its own bar
+    double median = count_ > 0 ? getPercentile(0.5) : 0.0;
+    sample.hitch = count_ > 0 && sample.frameMs >= hitchMinMs_ && sample.frameMs > hitchFactor_ * median;
+    if (sample.hitch) ++totalHitches_;
+
+    if (count_ == capacity_) popOldest();
+    push(sample);
+    return seconds;
+}
+
+void FrameStats::push(const FrameSample& sample) {
+    ring_[head_] = sample;
+    head_ = (head_ + 1) % capacity_;
+    ++count_;
+    ++histogram_[bucketOf(sample.frameMs)];
+    sumMs_ += sample.frameMs;
+}
+
+void FrameStats::popOldest() {
+    const FrameSample& oldest = ring_[(head_ + capacity_ - count_) % capacity_];
+    --histogram_[bucketOf(oldest.frameMs)];
+    sumMs_ -= oldest.frameMs;
+    --count_;
+}
+
+void FrameStats::setWindow(size_t frames) {
+    frames = std::max<size_t>(frames, 1);
+    if (frames == capacity_) return;
+
+    std::vector<FrameSample> samples = getSamples();
+    if (samples.size() > frames) samples.erase(samples.begin(), samples.end() - frames);
+
+    capacity_ = frames;
+    ring_.assign(capacity_, FrameSample());
+    std::fill(histogram_.begin(), histogram_.end(), 0);
+    head_ = count_ = 0;
+    sumMs_ = 0.0;
+    for (const FrameSample& sample : samples) push(sample);
+}
+
+void FrameStats::reset() {
+    std::fill(histogram_.begin(), histogram_.end(), 0);
+    head_ = count_ = 0;
+    sumMs_ = 0.0;
+    frameIndex_ = 0;
+    totalHitches_ = 0;
+    started_ = false;
+}
+
+double FrameStats::getPercentile(double fraction) const {
+    if (count_ == 0) return 0.0;
+
+    // Rank of the sample, then linear interpolation inside its bucket
+    double rank = std::clamp(fraction, 0.0, 1.0) * (count_ - 1) + 1.0;
+    double seen = 0.0;
+    for (size_t bucket = 0; bucket < histogram_.size(); ++bucket) {
+        if (histogram_[bucket] == 0) continue;
+        if (seen + histogram_[bucket] >= rank) {
+            double within = (rank - seen) / histogram_[bucket];
+            return (bucket + within) * kBucketMs;
+        }
+        seen += histogram_[bucket];
+    }
+    return kHistogramMs;
+}
+
+FrameStats::Summary FrameStats::getSummary() const {
+    Summary summary;
+    summary.frames = count_;
+    summary.totalHitches = totalHitches_;
+    if (count_ == 0) return summary;
+
+    summary.averageMs = sumMs_ / count_;
+    summary.p50Ms = getPercentile(0.50);
+    summary.p95Ms = getPercentile(0.95);
+    summary.p99Ms = getPercentile(0.99);
+    // Exact, not bucketed: the worst frame is what a hitch report is about
+    for (size_t i = 0; i < count_; ++i) {
+        const FrameSample& sample = ring_[(head_ + capacity_ - count_ + i) % capacity_];
+        summary.maxMs = std::max(summary.maxMs, static_cast<double>(sample.frameMs));
+        if (sample.hitch) ++summary.hitches;
+    }
+    return summary;
+}
+
+std::vector<FrameSample> FrameStats::getSamples() const {
+    std::vector<FrameSample> samples;
+    samples.reserve(count_);
+    for (size_t i = 0; i < count_; ++i)
+        samples.push_back(ring_[(head_ + capacity_ - count_ + i) % capacity_]);
+    return samples;
+}
+
+void FrameStats::copyFrameTimes(std::vector<float>& out) const {
+    out.resize(count_);
+    for (size_t i = 0; i < count_; ++i)
+        out[i] = ring_[(head_ + capacity_ - count_ + i) % capacity_].frameMs;
+}
+
+bool FrameStats::writeCsv(const std::string& path, size_t frames) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    std::vector<FrameSample> samples = getSamples();
+    size_t first = frames > 0 && frames < samples.size() ? samples.size() - frames : 0;
+
+    std::fprintf(file, "frame,time_s,frame_ms,gpu_ms,hitch\n");
+    for (size_t i = first; i < samples.size(); ++i) {
+        const FrameSample& sample = samples[i];
+        std::fprintf(file, "%llu,%.6f,%.4f,%.4f,%d\n", (unsigned long long)sample.index, sample.time, sample.frameMs,
+                     sample.gpuMs, sample.hitch ? 1 : 0);
+    }
+    return std::fclose(file) == 0;
+}
+
+bool FrameStats::writeJson(const std::string& path, size_t frames) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    std::vector<FrameSample> samples = getSamples();
+    size_t first = frames > 0 && frames < samples.size() ? samples.size() - frames : 0;
+    Summary summary = getSummary();
+
+    // Summary over the whole window, then the frames that were asked for
+    std::fprintf(file, "{\n  \"summary\": {\"frames\": %zu, \"average_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, "
+                       "\"p99_ms\": %.4f, \"max_ms\": %.4f, \"hitches\": %llu, \"total_hitches\": %llu},\n",
+                 summary.frames, summary.averageMs, summary.p50Ms, summary.p95Ms, summary.p99Ms, summary.maxMs,
+                 (unsigned long long)summary.hitches, (unsigned long long)summary.totalHitches);
+    std::fprintf(file, "  \"frames\": [\n");
+    for (size_t i = first; i < samples.size(); ++i) {
+        const FrameSample& sample = samples[i];
+        std::fprintf(file, "    {\"frame\": %llu, \"time_s\": %.6f, \"frame_ms\": %.4f, \"gpu_ms\": %.4f, \"hitch\": %s}%s\n",
+                     (unsigned long long)sample.index, sample.time, sample.frameMs, sample.gpuMs,
+                     sample.hitch ? "true" : "false", i + 1 < samples.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
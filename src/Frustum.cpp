@@ -0,0 +1,116 @@
+#include "Frustum.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TOON_CULL_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define TOON_CULL_NEON
+#endif
+
+AABB AABB::Transformed(const glm::mat4& m) const {
+    if (!IsValid()) return *this;
+
+    // Start from the translation and add the smaller/larger product of each matrix entry per axis
+    glm::vec3 outMin(m[3]), outMax(m[3]);
+    for (int column = 0; column < 3; ++column) {
+        for (int row = 0; row < 3; ++row) {
+            float a = m[column][row] * min[column];
+            float b = m[column][row] * max[column];
+            outMin[row] += std::fmin(a, b);
+            outMax[row] += std::fmax(a, b);
+        }
+    }
+    return AABB(outMin, outMax);
+}
+
+Frustum::Frustum() {
+    // Planes that every point is far in front of
+    for (int i = 0; i < 8; ++i) {
+        nx[i] = ny[i] = nz[i] = 0.0f;
+        ax[i] = ay[i] = az[i] = 0.0f;
+        d[i] = FLT_MAX;
+    }
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    Set(viewProjection);
+}
+
+void Frustum::Set(const glm::mat4& viewProjection) {
+    // Gribb/Hartmann: each plane is row 3 plus or minus row 0, 1 or 2 (GL clip space, -w <= z <= w)
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; ++i)
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    glm::vec4 planes[6] = {
+        row[3] + row[0], row[3] - row[0],
+        row[3] + row[1], row[3] - row[1],
+        row[3] + row[2], row[3] - row[2],
+    };
+
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 plane = planes[i < 6 ? i : 0];
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) plane /= length;
+
+        nx[i] = plane.x;
+        ny[i] = plane.y;
+        nz[i] = plane.z;
+        d[i] = plane.w;
+        ax[i] = std::fabs(plane.x);
+        ay[i] = std::fabs(plane.y);
+        az[i] = std::fabs(plane.z);
+    }
+}
+
+FrustumTest Frustum::Test(const AABB& box) const {
+    // Signed distance of the center vs. the box's projected radius, per plane:
+    // outside if distance < -radius for any plane, inside if distance >= radius for all of them
+    glm::vec3 center = box.GetCenter();
+    glm::vec3 extents = box.GetExtents();
+
+#if defined(TOON_CULL_SSE2)
+    const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+    const __m128 ex = _mm_set1_ps(extents.x), ey = _mm_set1_ps(extents.y), ez = _mm_set1_ps(extents.z);
+
+    int outside = 0, inside = 0xFF;
+    for (int i = 0; i < 8; i += 4) {
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(nx + i), cx), _mm_mul_ps(_mm_load_ps(ny + i), cy)),
+                                     _mm_add_ps(_mm_mul_ps(_mm_load_ps(nz + i), cz), _mm_load_ps(d + i)));
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(ax + i), ex), _mm_mul_ps(_mm_load_ps(ay + i), ey)),
+                                   _mm_mul_ps(_mm_load_ps(az + i), ez));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())) << i;
+        inside &= (_mm_movemask_ps(_mm_cmpge_ps(distance, radius)) << i) | ~(0xF << i);
+    }
+    if (outside) return FRUSTUM_OUTSIDE;
+    return inside == 0xFF ? FRUSTUM_INSIDE : FRUSTUM_INTERSECTS;
+#elif defined(TOON_CULL_NEON)
+    const float32x4_t cx = vdupq_n_f32(center.x), cy = vdupq_n_f32(center.y), cz = vdupq_n_f32(center.z);
+    const float32x4_t ex = vdupq_n_f32(extents.x), ey = vdupq_n_f32(extents.y), ez = vdupq_n_f32(extents.z);
+
+    uint32_t outside = 0, inside = ~0u;
+    for (int i = 0; i < 8; i += 4) {
+        float32x4_t distance = vmlaq_f32(vmlaq_f32(vmlaq_f32(vld1q_f32(d + i), vld1q_f32(nx + i), cx),
+                                                   vld1q_f32(ny + i), cy), vld1q_f32(nz + i), cz);
+        float32x4_t radius = vmlaq_f32(vmlaq_f32(vmulq_f32(vld1q_f32(ax + i), ex), vld1q_f32(ay + i), ey),
+                                       vld1q_f32(az + i), ez);
+        outside |= vmaxvq_u32(vcltq_f32(vaddq_f32(distance, radius), vdupq_n_f32(0.0f)));
+        inside &= vminvq_u32(vcgeq_f32(distance, radius));
+    }
+    if (outside) return FRUSTUM_OUTSIDE;
+    return inside ? FRUSTUM_INSIDE : FRUSTUM_INTERSECTS;
+#else
+    bool inside = true;
+    for (int i = 0; i < 6; ++i) {
+        float distance = nx[i] * center.x + ny[i] * center.y + nz[i] * center.z + d[i];
+        float radius = ax[i] * extents.x + ay[i] * extents.y + az[i] * extents.z;
+        if (distance + radius < 0.0f) return FRUSTUM_OUTSIDE;
+        if (distance < radius) inside = false;
+    }
+    return inside ? FRUSTUM_INSIDE : FRUSTUM_INTERSECTS;
+#endif
+}
@@ -0,0 +1,663 @@
+#include "GeomRenderer.h"
+#include "GeometryPool.h"
+#include "VertexPacking.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <cmath>
+
+// --- Primitive Geometry ---
+// All primitives are unit sized; the per-instance scale stretches them to geom_size.
+
+static void appendRings(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                        const std::vector<std::pair<float, float>>& rows, int slices) {
+    // rows = (polar angle, z offset). Consecutive rows are stitched into quads.
+    unsigned int base = static_cast<unsigned int>(vertices.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        float phi = rows[i].first;
+        for (int j = 0; j <= slices; ++j) {
+            float theta = 2.0f * glm::pi<float>() * j / slices;
+            glm::vec3 n(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi));
+
+            Vertex v;
+            v.Position = n + glm::vec3(0.0f, 0.0f, rows[i].second);
+            v.Normal = n;
+            v.TexCoords = glm::vec2((float)j / slices, (float)i / (rows.size() - 1));
+            vertices.push_back(v);
+        }
+    }
+    for (unsigned int i = 0; i + 1 < rows.size(); ++i) {
+        for (int j = 0; j < slices; ++j) {
+            unsigned int a = base + i * (slices + 1) + j;
+            unsigned int b = a + slices + 1;
+            indices.insert(indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+}
+
+// Sphere of radius 1 (also used for ellipsoids)
+static void createSphere(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const int stacks = 16, slices = 24;
+    std::vector<std::pair<float, float>> rows;
+    for (int i = 0; i <= stacks; ++i)
+        rows.push_back({ glm::pi<float>() * i / stacks, 0.0f });
+    appendRings(vertices, indices, rows, slices);
+}
+
+// Capsules are not scale invariant (round caps), so they are built at their real size
+static void createCapsule(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, float radius, float halfLength) {
+    const int stacks = 16, slices = 24;
+    std::vector<std::pair<float, float>> rows;
+    for (int i = 0; i <= stacks; ++i) {
+        float phi = glm::pi<float>() * i / stacks;
+        if (i == stacks / 2) {
+            // Duplicate the equator to open up the cylindrical section
+            rows.push_back({ phi, halfLength / radius });
+            rows.push_back({ phi, -halfLength / radius });
+        } else {
+            rows.push_back({ phi, (i < stacks / 2 ? halfLength : -halfLength) / radius });
+        }
+    }
+    appendRings(vertices, indices, rows, slices);
+    for (Vertex& v : vertices)
+        v.Position *= radius;
+}
+
+// Cylinder along Z with radius 1 and half-height 1
+static void createCylinder(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const int slices = 24;
+
+    // Side
+    for (int j = 0; j <= slices; ++j) {
+        float theta = 2.0f * glm::pi<float>() * j / slices;
+        glm::vec3 n(std::cos(theta), std::sin(theta), 0.0f);
+        vertices.push_back({ n + glm::vec3(0.0f, 0.0f, 1.0f), n, glm::vec2((float)j / slices, 1.0f) });
+        vertices.push_back({ n - glm::vec3(0.0f, 0.0f, 1.0f), n, glm::vec2((float)j / slices, 0.0f) });
+    }
+    for (unsigned int j = 0; j < (unsigned int)slices; ++j) {
+        unsigned int a = 2 * j;
+        indices.insert(indices.end(), { a, a + 1, a + 2, a + 2, a + 1, a + 3 });
+    }
+
+    // Caps
+    for (int cap = 0; cap < 2; ++cap) {
+        float z = cap == 0 ? 1.0f : -1.0f;
+        unsigned int center = static_cast<unsigned int>(vertices.size());
+        vertices.push_back({ glm::vec3(0.0f, 0.0f, z), glm::vec3(0.0f, 0.0f, z), glm::vec2(0.5f) });
+        for (int j = 0; j <= slices; ++j) {
+            float theta = 2.0f * glm::pi<float>() * j / slices;
+            glm::vec2 c(std::cos(theta), std::sin(theta));
+            vertices.push_back({ glm::vec3(c, z), glm::vec3(0.0f, 0.0f, z), c * 0.5f + 0.5f });
+        }
+        for (unsigned int j = 0; j < (unsigned int)slices; ++j) {
+            if (cap == 0) indices.insert(indices.end(), { center, center + 1 + j, center + 2 + j });
+            else          indices.insert(indices.end(), { center, center + 2 + j, center + 1 + j });
+        }
+    }
+}
+
+// Box with half-extents 1
+static void createBox(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            glm::vec3 n(0.0f);
+            n[axis] = side == 0 ? 1.0f : -1.0f;
+            glm::vec3 u(0.0f), v(0.0f);
+            u[(axis + 1) % 3] = 1.0f;
+            v[(axis + 2) % 3] = 1.0f;
+            if (side == 1) u = -u; // keep counter-clockwise winding
+
+            unsigned int base = static_cast<unsigned int>(vertices.size());
+            vertices.push_back({ n - u - v, n, glm::vec2(0.0f, 0.0f) });
+            vertices.push_back({ n + u - v, n, glm::vec2(1.0f, 0.0f) });
+            vertices.push_back({ n + u + v, n, glm::vec2(1.0f, 1.0f) });
+            vertices.push_back({ n - u + v, n, glm::vec2(0.0f, 1.0f) });
+            indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+        }
+    }
+}
+
+// Quad in the XY plane with half-extents 1, facing +Z
+static void createPlane(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    glm::vec3 n(0.0f, 0.0f, 1.0f);
+    vertices.push_back({ glm::vec3(-1.0f, -1.0f, 0.0f), n, glm::vec2(0.0f, 0.0f) });
+    vertices.push_back({ glm::vec3( 1.0f, -1.0f, 0.0f), n, glm::vec2(1.0f, 0.0f) });
+    vertices.push_back({ glm::vec3( 1.0f,  1.0f, 0.0f), n, glm::vec2(1.0f, 1.0f) });
+    vertices.push_back({ glm::vec3(-1.0f,  1.0f, 0.0f), n, glm::vec2(0.0f, 1.0f) });
+    indices.insert(indices.end(), { 0, 1, 2, 0, 2, 3 });
+}
+
+// Converts a compiled MuJoCo mesh. MuJoCo stores shared positions only, so normals are
+// smoothed across faces within a crease angle and vertices are split on hard edges.
+static void createMujocoMesh(const mjModel* m, int meshId, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const float* vert = m->mesh_vert + 3 * m->mesh_vertadr[meshId];
+    const int* face = m->mesh_face + 3 * m->mesh_faceadr[meshId];
+    int nvert = m->mesh_vertnum[meshId];
+    int nface = m->mesh_facenum[meshId];
+
+    const float creaseCos = std::cos(glm::radians(40.0f));
+
+    // Area-weighted face normals and vertex -> face adjacency
+    std::vector<glm::vec3> faceNormals(nface);
+    std::vector<std::vector<int>> vertexFaces(nvert);
+    for (int f = 0; f < nface; ++f) {
+        glm::vec3 p0(vert[3 * face[3 * f + 0]], vert[3 * face[3 * f + 0] + 1], vert[3 * face[3 * f + 0] + 2]);
+        glm::vec3 p1(vert[3 * face[3 * f + 1]], vert[3 * face[3 * f + 1] + 1], vert[3 * face[3 * f + 1] + 2]);
+        glm::vec3 p2(vert[3 * face[3 * f + 2]], vert[3 * face[3 * f + 2] + 1], vert[3 * face[3 * f + 2] + 2]);
+        faceNormals[f] = glm::cross(p1 - p0, p2 - p0);
+        for (int k = 0; k < 3; ++k)
+            vertexFaces[face[3 * f + k]].push_back(f);
+    }
+
+    // Each source vertex may be split into several output vertices (one per smoothing group)
+    std::vector<std::vector<std::pair<glm::vec3, unsigned int>>> splits(nvert);
+    indices.reserve(3 * nface);
+
+    for (int f = 0; f < nface; ++f) {
+        float len = glm::length(faceNormals[f]);
+        glm::vec3 fn = len > 0.0f ? faceNormals[f] / len : glm::vec3(0.0f, 0.0f, 1.0f);
+
+        for (int k = 0; k < 3; ++k) {
+            int vi = face[3 * f + k];
+
+            glm::vec3 n(0.0f);
+            for (int g : vertexFaces[vi]) {
+                float gl = glm::length(faceNormals[g]);
+                if (gl > 0.0f && glm::dot(faceNormals[g] / gl, fn) >= creaseCos)
+                    n += faceNormals[g];
+            }
+            n = glm::length(n) > 0.0f ? glm::normalize(n) : fn;
+
+            unsigned int index = 0;
+            bool found = false;
+            for (auto& split : splits[vi]) {
+                if (glm::dot(split.first, n) > 0.9999f) {
+                    index = split.second;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                index = static_cast<unsigned int>(vertices.size());
+                Vertex v;
+                v.Position = glm::vec3(vert[3 * vi], vert[3 * vi + 1], vert[3 * vi + 2]);
+                v.Normal = n;
+                v.TexCoords = glm::vec2(0.0f);
+                vertices.push_back(v);
+                splits[vi].push_back({ n, index });
+            }
+            indices.push_back(index);
+        }
+    }
+}
+
+// --- GeomRenderer ---
+
+GeomRenderer::GeomRenderer()
+    : simplifiedInstances(0), visibleInstances(0), lastSequence(0), interpDone(true), instanceModelVBO(0), instanceStaticVBO(0), instanceIdVBO(0),
+      instanceModelTexture(0), instanceStaticTexture(0), needsFullExport(true), lastUploadBytes(0)
+{
+    // MuJoCo's viewer default: groups 0-2 visible, 3-5 (usually collision) hidden
+    for (int i = 0; i < 6; ++i)
+        groupVisible[i] = i < 3;
+
+    worldTransform = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+}
+
+GeomRenderer::~GeomRenderer() {
+    clear();
+}
+
+void GeomRenderer::SetGeomGroupVisible(int group, bool visible) {
+    if (group >= 0 && group < 6)
+        groupVisible[group] = visible;
+}
+
+void GeomRenderer::clear() {
+    for (GeomGroup& group : groups) {
+        for (GroupLod& lod : group.lods)
+            glDeleteVertexArrays(1, &lod.VAO);
+        glDeleteBuffers(1, &group.VBO);
+        glDeleteBuffers(1, &group.EBO);
+    }
+    groups.clear();
+    instanceGeoms.clear();
+    instanceModels.clear();
+    geomModels.clear();
+    instanceSlot.clear();
+    interpGeoms.clear();
+    interpMark.clear();
+    instanceIds.clear();
+    instanceLods.clear();
+    instanceScale.clear();
+    bvh.Clear();
+    instanceProxy.clear();
+    instanceLocalBounds.clear();
+    visibleInstances = 0;
+    lastSequence = 0;
+    interpDone = true;
+    simplifiedInstances = 0;
+
+    if (instanceModelVBO) glDeleteBuffers(1, &instanceModelVBO);
+    if (instanceStaticVBO) glDeleteBuffers(1, &instanceStaticVBO);
+    if (instanceIdVBO) glDeleteBuffers(1, &instanceIdVBO);
+    if (instanceModelTexture) glDeleteTextures(1, &instanceModelTexture);
+    if (instanceStaticTexture) glDeleteTextures(1, &instanceStaticTexture);
+    instanceModelVBO = instanceStaticVBO = instanceIdVBO = 0;
+    instanceModelTexture = instanceStaticTexture = 0;
+    instanceMaterial = RenderMaterial();
+}
+
+void GeomRenderer::Build(const mjModel* m) {
+    clear();
+    if (!m) return;
+
+    // 1. Bucket geoms by shape
+    typedef std::tuple<int, int, float, float> GroupKey;
+    std::map<GroupKey, std::vector<int>> buckets;
+    std::vector<InstanceStatic> statics(m->ngeom);
+
+    for (int g = 0; g < m->ngeom; ++g) {
+        int type = m->geom_type[g];
+        int group = m->geom_group[g];
+        if (group >= 0 && group < 6 && !groupVisible[group]) continue;
+        if (type == mjGEOM_HFIELD || type == mjGEOM_SDF) continue; // not supported
+
+        const float* rgba = m->geom_matid[g] >= 0 ? m->mat_rgba + 4 * m->geom_matid[g] : m->geom_rgba + 4 * g;
+        if (rgba[3] <= 0.0f) continue; // invisible
+
+        const mjtNum* size = m->geom_size + 3 * g;
+        glm::vec3 scale(1.0f);
+        GroupKey key(type, -1, 0.0f, 0.0f);
+
+        switch (type) {
+            case mjGEOM_SPHERE:    scale = glm::vec3((float)size[0]); break;
+            case mjGEOM_ELLIPSOID:
+            case mjGEOM_BOX:       scale = glm::vec3((float)size[0], (float)size[1], (float)size[2]); break;
+            case mjGEOM_CYLINDER:  scale = glm::vec3((float)size[0], (float)size[0], (float)size[1]); break;
+            case mjGEOM_CAPSULE:   key = GroupKey(type, -1, (float)size[0], (float)size[1]); break;
+            case mjGEOM_PLANE:
+                // Zero size means infinite; draw it large instead
+                scale = glm::vec3(size[0] > 0 ? (float)size[0] : 50.0f, size[1] > 0 ? (float)size[1] : 50.0f, 1.0f);
+                break;
+            case mjGEOM_MESH:      key = GroupKey(type, m->geom_dataid[g], 0.0f, 0.0f); break;
+        }
+
+        statics[g].scale = glm::vec4(glm::max(scale, glm::vec3(1e-6f)), 0.0f);
+        statics[g].color = glm::vec4(rgba[0], rgba[1], rgba[2], rgba[3]);
+        buckets[key].push_back(g);
+    }
+
+    // 2. Lay instances out contiguously per group
+    std::vector<InstanceStatic> instanceStatics;
+    for (auto& bucket : buckets) {
+        GeomGroup group = {};
+        group.type = std::get<0>(bucket.first);
+        group.dataid = std::get<1>(bucket.first);
+        group.shapeKey = glm::vec2(std::get<2>(bucket.first), std::get<3>(bucket.first));
+        group.firstInstance = static_cast<int>(instanceGeoms.size());
+        group.instanceCount = static_cast<int>(bucket.second.size());
+        groups.push_back(group);
+
+        for (int g : bucket.second) {
+            instanceGeoms.push_back(g);
+            instanceStatics.push_back(statics[g]);
+            glm::vec3 scale = glm::vec3(statics[g].scale);
+            instanceScale.push_back(std::max(scale.x, std::max(scale.y, scale.z)));
+        }
+    }
+    instanceModels.assign(instanceGeoms.size(), glm::mat4(1.0f));
+    geomModels.assign(m->ngeom, glm::mat4(1.0f));
+    instanceSlot.assign(m->ngeom, -1);
+    for (size_t i = 0; i < instanceGeoms.size(); ++i)
+        instanceSlot[instanceGeoms[i]] = static_cast<int>(i);
+    interpMark.assign(m->ngeom, 0);
+    instanceLods.assign(instanceGeoms.size(), -1);
+    needsFullExport = true;
+
+    if (instanceGeoms.empty()) return;
+
+    glGenBuffers(1, &instanceModelVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceModelVBO);
+    glBufferData(GL_ARRAY_BUFFER, instanceModels.size() * sizeof(glm::mat4), instanceModels.data(), GL_DYNAMIC_DRAW);
+
+    glGenBuffers(1, &instanceStaticVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceStaticVBO);
+    glBufferData(GL_ARRAY_BUFFER, instanceStatics.size() * sizeof(InstanceStatic), instanceStatics.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The shader fetches matrices (4 texels) and scale/color (2 texels) by instance index
+    glGenTextures(1, &instanceModelTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, instanceModelTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, instanceModelVBO);
+    glGenTextures(1, &instanceStaticTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, instanceStaticTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, instanceStaticVBO);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    instanceMaterial.textures = { instanceModelTexture, instanceStaticTexture };
+    instanceMaterial.samplers = { Uniform<int>("instanceModels"), Uniform<int>("instanceStatics") };
+    instanceMaterial.targets = { GL_TEXTURE_BUFFER, GL_TEXTURE_BUFFER };
+
+    // Filled group by group in setupGroup; the VAOs only need the buffer name up front
+    glGenBuffers(1, &instanceIdVBO);
+
+    // 3. Geometry per group. Meshes get a simplified LOD chain; primitives are cheap enough as they are
+    int simplifiedGroups = 0;
+    for (GeomGroup& group : groups) {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+
+        switch (group.type) {
+            case mjGEOM_SPHERE:
+            case mjGEOM_ELLIPSOID: createSphere(vertices, indices); break;
+            case mjGEOM_CAPSULE:   createCapsule(vertices, indices, group.shapeKey.x, group.shapeKey.y); break;
+            case mjGEOM_CYLINDER:  createCylinder(vertices, indices); break;
+            case mjGEOM_BOX:       createBox(vertices, indices); break;
+            case mjGEOM_PLANE:     createPlane(vertices, indices); break;
+            case mjGEOM_MESH:      createMujocoMesh(m, group.dataid, vertices, indices); break;
+        }
+
+        std::vector<LodLevel> lods;
+        if (group.type == mjGEOM_MESH)
+            lods = MeshSimplifier::buildLodChain(vertices.data(), vertices.size(), indices);
+        if (!lods.empty()) ++simplifiedGroups;
+        setupGroup(group, vertices, indices, lods);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceIdVBO);
+    glBufferData(GL_ARRAY_BUFFER, instanceIds.size() * sizeof(int), instanceIds.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // 4. Culling proxies. Poses are identity until the first Update, which refits every geom.
+    for (const GeomGroup& group : groups) {
+        for (int i = 0; i < group.instanceCount; ++i) {
+            int slot = group.firstInstance + i;
+            glm::vec3 scale = glm::vec3(instanceStatics[slot].scale);
+            instanceLocalBounds.push_back(AABB(group.localBounds.min * scale, group.localBounds.max * scale));
+            instanceProxy.push_back(bvh.CreateProxy(instanceBounds(slot), slot));
+        }
+    }
+
+    std::cout << "GeomRenderer: " << instanceGeoms.size() << " geoms in " << groups.size() << " instanced groups ("
+              << simplifiedGroups << " with LODs)" << std::endl;
+}
+
+void GeomRenderer::setupGroup(GeomGroup& group, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                              const std::vector<LodLevel>& lods) {
+    // Every level in one index buffer, full detail first
+    std::vector<unsigned int> allIndices(indices);
+    group.lods.push_back({ 0, static_cast<GLsizei>(indices.size()), 0 });
+    group.lodErrors.push_back(0.0f);
+    for (const LodLevel& lod : lods) {
+        group.lods.push_back({ static_cast<GLsizei>(allIndices.size()), static_cast<GLsizei>(lod.indices.size()), 0 });
+        group.lodErrors.push_back(std::max(lod.error, group.lodErrors.back()));
+        allIndices.insert(allIndices.end(), lod.indices.begin(), lod.indices.end());
+    }
+
+    group.radius = 0.0f;
+    group.localBounds = AABB();
+    for (const Vertex& v : vertices) {
+        group.radius = std::max(group.radius, glm::length(v.Position));
+        group.localBounds.Expand(v.Position);
+    }
+
+    // Level 0 starts out with every instance; Submit re-buckets them by visibility and level
+    group.firstId = static_cast<int>(instanceIds.size());
+    for (size_t level = 0; level < group.lods.size(); ++level)
+        for (int i = 0; i < group.instanceCount; ++i)
+            instanceIds.push_back(level == 0 ? group.firstInstance + i : 0);
+
+    // Packed like imported models: 16-byte vertices dequantized through ObjectData, and
+    // 16-bit indices unless the group is too big (every instance re-fetches these)
+    group.positionScale = glm::vec3(1.0f);
+    group.positionBias = glm::vec3(0.0f);
+    if (!vertices.empty())
+        VertexPacking::quantization(group.localBounds.min, group.localBounds.max, group.positionScale, group.positionBias);
+    std::vector<PackedVertex> packed(vertices.size());
+    for (size_t v = 0; v < vertices.size(); ++v)
+        packed[v] = VertexPacking::pack(vertices[v], group.positionScale, group.positionBias);
+
+    std::vector<uint16_t> shortIndices;
+    group.indexType = VertexPacking::fitsShortIndices(vertices.size()) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    if (group.indexType == GL_UNSIGNED_SHORT) shortIndices = VertexPacking::shortIndices(allIndices.data(), allIndices.size());
+
+    glGenBuffers(1, &group.VBO);
+    glGenBuffers(1, &group.EBO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, group.VBO);
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
+
+    const VertexLayout layout = GeometryPool::GetLayout(VertexFormat::Packed);
+    for (size_t level = 0; level < group.lods.size(); ++level) {
+        GroupLod& lod = group.lods[level];
+        glGenVertexArrays(1, &lod.VAO);
+        glBindVertexArray(lod.VAO);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, group.EBO);
+        if (level == 0) {
+            if (group.indexType == GL_UNSIGNED_SHORT)
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(), GL_STATIC_DRAW);
+            else
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, allIndices.size() * sizeof(unsigned int), allIndices.data(), GL_STATIC_DRAW);
+        }
+
+        // Same per-vertex layout as the packed geometry pool
+        glBindBuffer(GL_ARRAY_BUFFER, group.VBO);
+        for (const VertexAttribute& attribute : layout.attributes) {
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized,
+                                  layout.stride, (void*)attribute.offset);
+        }
+
+        // Instance index (location 3), offset to this level's block of the shared id buffer
+        glBindBuffer(GL_ARRAY_BUFFER, instanceIdVBO);
+        size_t idOffset = (group.firstId + level * group.instanceCount) * sizeof(int);
+        glEnableVertexAttribArray(3);
+        glVertexAttribIPointer(3, 1, GL_INT, sizeof(int), (void*)idOffset);
+        glVertexAttribDivisor(3, 1);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GeomRenderer::Update(MujocoSim& sim) {
+    lastUploadBytes = 0;
+    if (instanceGeoms.empty()) return;
+
+    // geomModels is new after a Build, so the sim must not skip anything
+    if (needsFullExport) {
+        sim.invalidatePoses();
+        needsFullExport = false;
+    }
+
+    changedGeoms.clear();
+    if (sim.exportGeomPoses(&geomModels[0][0][0], 0, -1, &changedGeoms) == 0)
+        return; // nothing moved (static or sleeping scene): zero upload
+
+    dirtySlots.clear();
+    for (int g : changedGeoms) {
+        int slot = instanceSlot[g];
+        if (slot < 0) continue; // hidden group
+        instanceModels[slot] = geomModels[g];
+        dirtySlots.push_back(slot);
+    }
+    uploadDirtySlots();
+    refitDirtySlots();
+}
+
+// Rigid blend: lerp translation, slerp rotation
+static glm::mat4 interpolatePose(const glm::mat4& a, const glm::mat4& b, float t) {
+    if (t <= 0.0f) return a;
+    if (t >= 1.0f) return b;
+
+    glm::quat qa = glm::quat_cast(glm::mat3(a));
+    glm::quat qb = glm::quat_cast(glm::mat3(b));
+    glm::mat4 result = glm::mat4_cast(glm::slerp(qa, qb, t));
+    result[3] = glm::mix(a[3], b[3], t);
+    return result;
+}
+
+void GeomRenderer::Update(const PhysicsThread& physics, double wallNow) {
+    lastUploadBytes = 0;
+    const PoseSnapshot& current = physics.getCurrent();
+    const PoseSnapshot& previous = physics.getPrevious();
+    if (instanceGeoms.empty() || current.geomModels.size() != instanceSlot.size()) return;
+
+    // 1. New snapshot: collect what moves between previous and current.
+    //    Geoms that stopped in current still need one final write, hence the union.
+    //    Everything is rewritten only when the lists don't chain: a new geom count, or a
+    //    snapshot taken by poll() that never reached this Update.
+    if (current.sequence != lastSequence) {
+        bool full = physics.hasGap() || previous.sequence != lastSequence;
+        interpGeoms.clear();
+
+        if (full) {
+            interpGeoms = instanceGeoms;
+        } else {
+            for (const std::vector<int>* list : { &previous.changed, &current.changed }) {
+                for (int g : *list) {
+                    if (instanceSlot[g] < 0 || interpMark[g]) continue;
+                    interpMark[g] = 1;
+                    interpGeoms.push_back(g);
+                }
+            }
+            for (int g : interpGeoms) interpMark[g] = 0;
+        }
+        lastSequence = current.sequence;
+        interpDone = false;
+    }
+
+    // Already at the current snapshot and nothing new: zero upload
+    if (interpDone) return;
+
+    // 2. Blend and upload
+    bool hasPrevious = previous.geomModels.size() == current.geomModels.size();
+    float alpha = hasPrevious ? physics.getInterpolationAlpha(wallNow) : 1.0f;
+
+    dirtySlots.clear();
+    for (int g : interpGeoms) {
+        int slot = instanceSlot[g];
+        instanceModels[slot] = hasPrevious ? interpolatePose(previous.geomModels[g], current.geomModels[g], alpha)
+                                           : current.geomModels[g];
+        dirtySlots.push_back(slot);
+    }
+    uploadDirtySlots();
+    refitDirtySlots();
+
+    if (alpha >= 1.0f) interpDone = true;
+}
+
+void GeomRenderer::uploadDirtySlots() {
+    if (dirtySlots.empty()) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceModelVBO);
+
+    // Mostly dirty: one upload of everything is cheaper than many small ones
+    if (dirtySlots.size() * 2 > instanceModels.size()) {
+        lastUploadBytes = instanceModels.size() * sizeof(glm::mat4);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, lastUploadBytes, instanceModels.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+
+    // Coalesce nearby slots into runs; small gaps are re-uploaded rather than split
+    const int maxGap = 4;
+    std::sort(dirtySlots.begin(), dirtySlots.end());
+
+    size_t i = 0;
+    while (i < dirtySlots.size()) {
+        int start = dirtySlots[i];
+        int end = start;
+        while (i + 1 < dirtySlots.size() && dirtySlots[i + 1] - end <= maxGap)
+            end = dirtySlots[++i];
+        ++i;
+
+        size_t bytes = (end - start + 1) * sizeof(glm::mat4);
+        glBufferSubData(GL_ARRAY_BUFFER, start * sizeof(glm::mat4), bytes, &instanceModels[start]);
+        lastUploadBytes += bytes;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+AABB GeomRenderer::instanceBounds(int slot) const {
+    return instanceLocalBounds[slot].Transformed(worldTransform * instanceModels[slot]);
+}
+
+void GeomRenderer::refitDirtySlots() {
+    // Most moves stay inside the fat box and don't touch the tree
+    for (int slot : dirtySlots)
+        bvh.MoveProxy(instanceProxy[slot], instanceBounds(slot));
+}
+
+void GeomRenderer::Submit(RenderQueue& queue, Shader& shader, const LodView& lodView, const Frustum& frustum) {
+    ObjectUniforms object = UniformBuffers::MakeObject(worldTransform, glm::vec3(1.0f), false);
+    simplifiedInstances = 0;
+
+    visibleSlots.clear();
+    bvh.Query(frustum, visibleSlots);
+    visibleInstances = static_cast<int>(visibleSlots.size());
+    instanceVisible.assign(instanceGeoms.size(), 0);
+    for (int slot : visibleSlots) instanceVisible[slot] = 1;
+
+    // Range of instanceIds rewritten this frame
+    size_t dirtyBegin = instanceIds.size(), dirtyEnd = 0;
+
+    for (const GeomGroup& group : groups) {
+        int levels = static_cast<int>(group.lods.size());
+        levelFill.assign(levels, 0);
+
+        // Bucket visible instances by level: each level's block lists its instances from the front
+        for (int i = 0; i < group.instanceCount; ++i) {
+            int slot = group.firstInstance + i;
+            if (!instanceVisible[slot]) continue;
+
+            int level = 0;
+            if (levels > 1) {
+                glm::vec3 center = glm::vec3(worldTransform * instanceModels[slot][3]);
+                float distance = glm::length(center - lodView.cameraPosition) - group.radius * instanceScale[slot];
+                level = LodSelector::select(group.lodErrors.data(), levels, instanceScale[slot], distance, lodView,
+                                            instanceLods[slot]);
+                instanceLods[slot] = level;
+                if (level > 0) ++simplifiedInstances;
+            }
+
+            size_t id = group.firstId + level * group.instanceCount + levelFill[level]++;
+            if (instanceIds[id] != slot) {
+                instanceIds[id] = slot;
+                dirtyBegin = std::min(dirtyBegin, id);
+                dirtyEnd = std::max(dirtyEnd, id + 1);
+            }
+        }
+
+        object.positionScale = glm::vec4(group.positionScale, 1.0f);
+        object.positionBias = glm::vec4(group.positionBias, 0.0f);
+        for (int level = 0; level < levels; ++level) {
+            if (levelFill[level] == 0) continue;
+
+            DrawPacket packet;
+            packet.shader = &shader;
+            packet.material = &instanceMaterial;
+            packet.VAO = group.lods[level].VAO;
+            packet.firstIndex = group.lods[level].firstIndex;
+            packet.count = group.lods[level].indexCount;
+            packet.indexType = group.indexType;
+            packet.instanceCount = levelFill[level];
+            queue.Add(packet, object);
+        }
+    }
+
+    // Only the ids of instances that changed level, visibility or order go up
+    if (dirtyBegin < dirtyEnd) {
+        size_t bytes = (dirtyEnd - dirtyBegin) * sizeof(int);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceIdVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, dirtyBegin * sizeof(int), bytes, &instanceIds[dirtyBegin]);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        lastUploadBytes += bytes;
+    }
+}
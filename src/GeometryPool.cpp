@@ -0,0 +1,237 @@
+#include "GeometryPool.h"
+#include "Mesh.h"
+#include <algorithm>
+#include <iterator>
+
+// --- RangeAllocator ---
+
+RangeAllocator::RangeAllocator(size_t capacity) : capacity(capacity), used(0) {
+    if (capacity > 0) freeRanges[0] = capacity;
+}
+
+bool RangeAllocator::Allocate(size_t size, size_t& offset) {
+    if (size == 0) {
+        offset = 0;
+        return true;
+    }
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        if (it->second < size) continue;
+
+        offset = it->first;
+        size_t remaining = it->second - size;
+        freeRanges.erase(it);
+        if (remaining > 0) freeRanges[offset + size] = remaining;
+        used += size;
+        return true;
+    }
+    return false;
+}
+
+void RangeAllocator::Free(size_t offset, size_t size) {
+    if (size == 0) return;
+    used -= size;
+
+    auto next = freeRanges.lower_bound(offset);
+
+    // Merge with the range that ends where this one starts
+    if (next != freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            freeRanges.erase(previous);
+        }
+    }
+    // ...and with the one that starts where it ends
+    if (next != freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        freeRanges.erase(next);
+    }
+    freeRanges[offset] = size;
+}
+
+void RangeAllocator::Grow(size_t newCapacity) {
+    if (newCapacity <= capacity) return;
+    size_t added = newCapacity - capacity;
+    size_t start = capacity;
+    capacity = newCapacity;
+    used += added; // Free subtracts it again
+    Free(start, added);
+}
+
+// --- GeometryPool ---
+
+std::map<std::pair<VertexFormat, GLenum>, std::unique_ptr<GeometryPool>> GeometryPool::pools;
+
+VertexLayout GeometryPool::GetLayout(VertexFormat format) {
+    VertexLayout layout;
+    if (format == VertexFormat::Packed) {
+        // Same attribute locations as Vertex: the shaders read vec3/vec3/vec2 either way
+        layout.stride = sizeof(PackedVertex);
+        layout.attributes = {
+            { 0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedVertex, Position) },
+            { 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedVertex, Normal) },
+            { 2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedVertex, TexCoords) },
+        };
+    } else {
+        layout.stride = sizeof(Vertex);
+        layout.attributes = {
+            { 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Position) },
+            { 1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Normal) },
+            { 2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, TexCoords) },
+        };
+    }
+    return layout;
+}
+
+GeometryPool& GeometryPool::Get(VertexFormat format, GLenum indexType) {
+    std::unique_ptr<GeometryPool>& pool = pools[{ format, indexType }];
+    if (!pool) {
+        // 256K vertices and 1M indices to start with; grows on demand
+        pool = std::make_unique<GeometryPool>(GetLayout(format), indexType, 256 * 1024, 1024 * 1024);
+    }
+    return *pool;
+}
+
+void GeometryPool::DestroyAll() {
+    pools.clear();
+}
+
+size_t GeometryPool::GetTotalVertexCount() {
+    size_t total = 0;
+    for (const auto& entry : pools) total += entry.second->GetVertexCount();
+    return total;
+}
+
+size_t GeometryPool::GetTotalBufferBytes() {
+    size_t total = 0;
+    for (const auto& entry : pools) total += entry.second->GetBufferBytes();
+    return total;
+}
+
+GeometryPool::GeometryPool(const VertexLayout& layout, GLenum indexType, size_t vertexCapacity, size_t indexCapacity)
+    : layout(layout), indexType(indexType), vertexRanges(vertexCapacity), indexRanges(indexCapacity) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCapacity * layout.stride, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, indexCapacity * GetIndexSize(), NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    bindLayout();
+}
+
+GeometryPool::~GeometryPool() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+}
+
+void GeometryPool::bindLayout() {
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    for (const VertexAttribute& attribute : layout.attributes) {
+        glEnableVertexAttribArray(attribute.location);
+        glVertexAttribPointer(attribute.location, attribute.size, attribute.type, attribute.normalized,
+                              layout.stride, (void*)attribute.offset);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GeometryPool::growBuffer(unsigned int& buffer, size_t oldBytes, size_t newBytes) {
+    // Copy on the GPU so offsets handed out so far stay valid
+    unsigned int grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, newBytes, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &buffer);
+    buffer = grown;
+}
+
+GeometryAllocation GeometryPool::Allocate(const void* vertexData, size_t vertexCount, const void* indexData, size_t indexCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t vertexOffset = 0, indexOffset = 0;
+    bool grew = false;
+
+    if (!vertexRanges.Allocate(vertexCount, vertexOffset)) {
+        size_t oldCapacity = vertexRanges.GetCapacity();
+        size_t newCapacity = std::max(oldCapacity * 2, oldCapacity + vertexCount);
+        growBuffer(VBO, oldCapacity * layout.stride, newCapacity * layout.stride);
+        vertexRanges.Grow(newCapacity);
+        vertexRanges.Allocate(vertexCount, vertexOffset);
+        grew = true;
+    }
+    if (allocateIndexRange(indexCount, indexOffset)) grew = true;
+    // Same VAO name, new buffers behind it: sort keys and batches stay valid
+    if (grew) bindLayout();
+
+    // GL_COPY_WRITE_BUFFER: binding GL_ELEMENT_ARRAY_BUFFER here would need the VAO bound
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * layout.stride, vertexCount * layout.stride, vertexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * GetIndexSize(), indexCount * GetIndexSize(), indexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    GeometryAllocation allocation;
+    allocation.baseVertex = static_cast<GLint>(vertexOffset);
+    allocation.vertexCount = static_cast<GLsizei>(vertexCount);
+    allocation.firstIndex = static_cast<GLsizei>(indexOffset);
+    allocation.indexCount = static_cast<GLsizei>(indexCount);
+    return allocation;
+}
+
+GeometryAllocation GeometryPool::AllocateIndices(const GeometryAllocation& vertices, const void* indexData, size_t indexCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t indexOffset = 0;
+    if (allocateIndexRange(indexCount, indexOffset)) bindLayout();
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * GetIndexSize(), indexCount * GetIndexSize(), indexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // No vertices of its own: Free leaves the shared ones alone
+    GeometryAllocation allocation;
+    allocation.baseVertex = vertices.baseVertex;
+    allocation.vertexCount = 0;
+    allocation.firstIndex = static_cast<GLsizei>(indexOffset);
+    allocation.indexCount = static_cast<GLsizei>(indexCount);
+    return allocation;
+}
+
+bool GeometryPool::allocateIndexRange(size_t indexCount, size_t& indexOffset) {
+    if (indexRanges.Allocate(indexCount, indexOffset)) return false;
+
+    size_t oldCapacity = indexRanges.GetCapacity();
+    size_t newCapacity = std::max(oldCapacity * 2, oldCapacity + indexCount);
+    growBuffer(EBO, oldCapacity * GetIndexSize(), newCapacity * GetIndexSize());
+    indexRanges.Grow(newCapacity);
+    indexRanges.Allocate(indexCount, indexOffset);
+    return true;
+}
+
+void GeometryPool::Free(const GeometryAllocation& allocation) {
+    if (!allocation.IsValid()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    vertexRanges.Free(allocation.baseVertex, allocation.vertexCount);
+    indexRanges.Free(allocation.firstIndex, allocation.indexCount);
+}
+
+size_t GeometryPool::GetBufferBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return vertexRanges.GetCapacity() * layout.stride + indexRanges.GetCapacity() * GetIndexSize();
+}
@@ -0,0 +1,142 @@
+#include "HeadlessContext.h"
+
+#include <iostream>
+
+#ifdef TOON_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::~HeadlessContext() {
+    Destroy();
+}
+
+bool HeadlessContext::Create(int width, int height) {
+    if (createEgl()) return true;
+    return createGlfw(width, height);
+}
+
+void HeadlessContext::Destroy() {
+#ifdef TOON_HAS_EGL
+    if (eglDisplay) {
+        EGLDisplay display = static_cast<EGLDisplay>(eglDisplay);
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (eglSurface) eglDestroySurface(display, static_cast<EGLSurface>(eglSurface));
+        if (eglContext) eglDestroyContext(display, static_cast<EGLContext>(eglContext));
+        eglTerminate(display);
+    }
+#endif
+    eglDisplay = eglContext = eglSurface = nullptr;
+    usingEgl = false;
+
+    if (window) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        window = nullptr;
+    }
+}
+
+bool HeadlessContext::createEgl() {
+#ifdef TOON_HAS_EGL
+    // The surfaceless platform needs neither X11 nor Wayland; older drivers only have the default display
+    EGLDisplay display = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay) display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        std::cout << "ERROR::HEADLESS::EGL_NO_DISPLAY" << std::endl;
+        return false;
+    }
+    eglDisplay = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cout << "ERROR::HEADLESS::EGL_NO_OPENGL_API" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    // Prefer pbuffer-capable configs for the fallback surface; surfaceless displays may have none
+    EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        configAttribs[1] = 0; // any surface type
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+            std::cout << "ERROR::HEADLESS::EGL_NO_CONFIG" << std::endl;
+            Destroy();
+            return false;
+        }
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 1,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) {
+        std::cout << "ERROR::HEADLESS::EGL_CONTEXT_FAILED 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        Destroy();
+        return false;
+    }
+    eglContext = context;
+
+    // Everything renders into FBOs, so no surface is needed (EGL_KHR_surfaceless_context);
+    // drivers without it get a 1x1 pbuffer
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        EGLSurface surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+        if (surface == EGL_NO_SURFACE || !eglMakeCurrent(display, surface, surface, context)) {
+            std::cout << "ERROR::HEADLESS::EGL_MAKE_CURRENT_FAILED" << std::endl;
+            if (surface != EGL_NO_SURFACE) eglSurface = surface;
+            Destroy();
+            return false;
+        }
+        eglSurface = surface;
+    }
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+        std::cout << "ERROR::HEADLESS::GLAD_LOAD_FAILED" << std::endl;
+        Destroy();
+        return false;
+    }
+    usingEgl = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool HeadlessContext::createGlfw(int width, int height) {
+    if (!glfwInit()) {
+        std::cout << "ERROR::HEADLESS::GLFW_INIT_FAILED" << std::endl;
+        return false;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    window = glfwCreateWindow(width, height, "Toon Engine (headless)", NULL, NULL);
+    if (!window) {
+        std::cout << "ERROR::HEADLESS::GLFW_WINDOW_FAILED" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "ERROR::HEADLESS::GLAD_LOAD_FAILED" << std::endl;
+        Destroy();
+        return false;
+    }
+    return true;
+}
@@ -1,25 +1,85 @@
 #include "Mesh.h"
+#include <algorithm>
 #include <string>
-//include random number generator
-#include <random>
-
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures) {
-    this->vertices = vertices;
-    this->indices = indices;
-    this->textures = textures;
-    this->hasTexture = !textures.empty();
-    this->baseColor = glm::vec3((float)rand() / RAND_MAX, (float)rand() / RAND_MAX, (float)rand() / RAND_MAX); // random color
-    setupMesh();
+
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures,
+           const glm::vec3& baseColor, bool keepCpuData) {
+    this->vertices = std::move(vertices);
+    this->indices = std::move(indices);
+    this->textures = std::move(textures);
+    this->hasTexture = !this->textures.empty();
+    this->baseColor = baseColor;
+    for (const Vertex& vertex : this->vertices) bounds.Expand(vertex.Position);
+    resolveMaterial();
+    setupMesh(VertexFormat::Standard, this->vertices.data(), this->vertices.size(), GL_UNSIGNED_INT, this->indices.data(), this->indices.size());
+
+    // The pool has its own copy now
+    if (!keepCpuData) {
+        std::vector<Vertex>().swap(this->vertices);
+        std::vector<unsigned int>().swap(this->indices);
+    }
+}
+
+Mesh::Mesh(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount, std::vector<Texture> textures,
+           const glm::vec3& baseColor) {
+    this->textures = std::move(textures);
+    this->hasTexture = !this->textures.empty();
+    this->baseColor = baseColor;
+    for (size_t i = 0; i < vertexCount; ++i) bounds.Expand(vertices[i].Position);
+    resolveMaterial();
+    setupMesh(VertexFormat::Standard, vertices, vertexCount, GL_UNSIGNED_INT, indices, indexCount);
+}
+
+Mesh::Mesh(VertexFormat format, const void* vertices, size_t vertexCount, GLenum indexType, const void* indices, size_t indexCount,
+           std::vector<Texture> textures, const glm::vec3& baseColor) {
+    this->textures = std::move(textures);
+    this->hasTexture = !this->textures.empty();
+    this->baseColor = baseColor;
+    resolveMaterial();
+    setupMesh(format, vertices, vertexCount, indexType, indices, indexCount);
+}
+
+Mesh::~Mesh() {
+    releaseGeometry();
 }
 
-void Mesh::Draw(unsigned int shaderProgram) {
-    // 1. Bind Textures
+Mesh::Mesh(Mesh&& other) noexcept
+    : vertices(std::move(other.vertices)), indices(std::move(other.indices)), textures(std::move(other.textures)),
+      hasTexture(other.hasTexture), baseColor(other.baseColor), bounds(other.bounds), indexCount(other.indexCount),
+      pool(other.pool), geometry(other.geometry), lods(std::move(other.lods)), lodErrors(std::move(other.lodErrors)),
+      format(other.format), material(std::move(other.material)) {
+    other.pool = nullptr;
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this != &other) {
+        releaseGeometry();
+        vertices = std::move(other.vertices);
+        indices = std::move(other.indices);
+        textures = std::move(other.textures);
+        hasTexture = other.hasTexture;
+        baseColor = other.baseColor;
+        bounds = other.bounds;
+        indexCount = other.indexCount;
+        pool = other.pool;
+        geometry = other.geometry;
+        lods = std::move(other.lods);
+        lodErrors = std::move(other.lodErrors);
+        format = other.format;
+        material = std::move(other.material);
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+void Mesh::resolveMaterial() {
+    // Sampler names follow texture_diffuseN / texture_specularN, counted per type
     unsigned int diffuseNr  = 1;
     unsigned int specularNr = 1;
 
+    material.textures.clear();
+    material.samplers.clear();
     for(unsigned int i = 0; i < textures.size(); i++) {
-        glActiveTexture(GL_TEXTURE0 + i); // Active proper texture unit
-        
         // retrieve texture number (the N in texture_diffuseN)
         std::string number;
         std::string name = textures[i].type;
@@ -29,50 +89,52 @@ void Mesh::Draw(unsigned int shaderProgram) {
         else if(name == "texture_specular")
             number = std::to_string(specularNr++); 
 
-        // Set the sampler to the correct texture unit
-        glUniform1i(glGetUniformLocation(shaderProgram, (name + number).c_str()), i);
-        // Bind the texture
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        material.textures.push_back(textures[i].id);
+        material.samplers.emplace_back(name + number);
     }
-    
-
-    // Set the shader uniforms
-    glUniform1i(glGetUniformLocation(shaderProgram, "hasTexture"), hasTexture);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "baseColor"), 1, &baseColor[0]);
+}
 
-    // 2. Draw Mesh
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+void Mesh::setupMesh(VertexFormat format, const void* vertexData, size_t vertexCount, GLenum indexType, const void* indexData, size_t indexCount) {
+    this->indexCount = static_cast<unsigned int>(indexCount);
 
-    // Reset
-    glActiveTexture(GL_TEXTURE0);
+    // Shared buffers: no VAO/VBO/EBO of our own
+    this->format = format;
+    pool = &GeometryPool::Get(format, indexType);
+    geometry = pool->Allocate(vertexData, vertexCount, indexData, indexCount);
 }
 
-void Mesh::setupMesh() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
 
-    glBindVertexArray(VAO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+void Mesh::AddLod(const void* indices, size_t indexCount, float error) {
+    if (!pool || indexCount == 0) return;
+    lods.push_back(pool->AllocateIndices(geometry, indices, indexCount));
+    lodErrors.push_back(error);
+}
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+const GeometryAllocation& Mesh::GetLod(int level) const {
+    if (level <= 0 || lods.empty()) return geometry;
+    return lods[std::min(static_cast<size_t>(level), lods.size()) - 1];
+}
 
-    // Vertex Positions
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    
-    // Vertex Normals
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+float Mesh::GetLodError(int level) const {
+    if (level <= 0 || lodErrors.empty()) return 0.0f;
+    return lodErrors[std::min(static_cast<size_t>(level), lodErrors.size()) - 1];
+}
 
-    // Vertex Texture Coords
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+size_t Mesh::GetCpuBytes() const {
+    return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(unsigned int);
+}
+
+size_t Mesh::GetGpuBytes() const {
+    if (!pool) return 0;
+    size_t indexCount = geometry.indexCount;
+    for (const GeometryAllocation& lod : lods) indexCount += lod.indexCount;
+    return geometry.vertexCount * pool->GetVertexSize() + indexCount * pool->GetIndexSize();
+}
 
-    glBindVertexArray(0);
+void Mesh::releaseGeometry() {
+    if (!pool) return;
+    for (const GeometryAllocation& lod : lods) pool->Free(lod);
+    pool->Free(geometry);
+    lods.clear();
+    lodErrors.clear();
 }
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "MeshCache.h"
+#include "FileSystem.h"
+#include "Hash.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <unordered_map>
+
+// --- File Layout ---
+// Header | MeshRecord[meshCount] | TextureRecord[textureCount] | LodRecord[lodCount] | strings + embedded blobs
+//        | vertex/index arrays
+// All offsets are absolute; arrays are 16-byte aligned so the mapped pointers are too.
+
+namespace {
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t importFlags;
+    uint32_t meshCount;
+    uint64_t sourceHash;
+    uint32_t textureCount;
+    uint32_t vertexSize; // sizeof(Vertex) at write time
+    uint64_t fileSize;
+    uint32_t lodCount;
+    uint32_t reserved;
+};
+
+struct MeshRecord {
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t firstTexture;
+    uint32_t textureCount;
+    float baseColor[4]; // rgb, w unused
+    float boundsMin[4]; // xyz, w unused
+    float boundsMax[4];
+    uint32_t firstLod;
+    uint32_t lodCount;
+};
+
+struct LodRecord {
+    uint64_t indexOffset;
+    uint32_t indexCount;
+    float error;
+};
+
+struct TextureRecord {
+    uint64_t typeOffset;
+    uint64_t pathOffset;
+    uint64_t dataOffset;
+    uint32_t typeLength;
+    uint32_t pathLength;
+    uint64_t dataSize;
+};
+
+const char kMagic[4] = { 'T', 'M', 'S', 'H' };
+
+class ByteWriter {
+public:
+    std::vector<unsigned char> bytes;
+
+    uint64_t append(const void* data, size_t size, size_t alignment = 1) {
+        size_t offset = (bytes.size() + alignment - 1) / alignment * alignment;
+        bytes.resize(offset + size);
+        if (data && size) std::memcpy(bytes.data() + offset, data, size);
+        return offset;
+    }
+};
+
+bool inRange(uint64_t offset, uint64_t size, size_t fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+} // namespace
+
+std::string MeshCache::pathFor(const std::string& modelPath) {
+    std::filesystem::path path(modelPath);
+    return FileSystem::getCachePath("meshes/" + path.stem().string() + "_" + Hash::toHex(Hash::fnv1a(modelPath)) + ".tmesh");
+}
+
+bool MeshCache::hashSource(const std::string& modelPath, uint64_t& hash) {
+    hash = Hash::kSeed;
+    if (!Hash::file(modelPath, hash)) return false;
+
+    // Side files that change the import result without touching the main file
+    std::string extension = std::filesystem::path(modelPath).extension().string();
+    std::regex reference;
+    if (extension == ".obj" || extension == ".OBJ") reference = std::regex("mtllib\\s+([^\\r\\n]+)");
+    else if (extension == ".gltf") reference = std::regex("\"uri\"\\s*:\\s*\"([^\"]+)\"");
+    else return true;
+
+    std::ifstream stream(modelPath, std::ios::binary);
+    std::stringstream ss;
+    ss << stream.rdbuf();
+    std::string text = ss.str();
+
+    std::filesystem::path directory = std::filesystem::path(modelPath).parent_path();
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), reference); it != std::sregex_iterator(); ++it) {
+        std::string name = (*it)[1].str();
+        if (name.rfind("data:", 0) == 0) continue; // inline glTF buffer, already hashed
+        hash = Hash::fnv1a(name, hash);
+        Hash::file((directory / name).string(), hash); // a missing .mtl is not fatal for Assimp either
+    }
+    return true;
+}
+
+bool MeshCache::read(const std::string& cachePath, uint32_t importFlags, uint64_t sourceHash,
+                     MappedFile& file, std::vector<MeshSource>& meshes) {
+    meshes.clear();
+    if (!file.open(cachePath)) return false;
+
+    const unsigned char* base = file.data();
+    size_t size = file.size();
+
+    if (size < sizeof(FileHeader)) return false;
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion ||
+        header.importFlags != importFlags || header.sourceHash != sourceHash ||
+        header.vertexSize != sizeof(Vertex) || header.fileSize != size) {
+        return false;
+    }
+
+    uint64_t meshTable = sizeof(FileHeader);
+    uint64_t textureTable = meshTable + header.meshCount * sizeof(MeshRecord);
+    uint64_t lodTable = textureTable + header.textureCount * sizeof(TextureRecord);
+    if (!inRange(meshTable, header.meshCount * sizeof(MeshRecord), size) ||
+        !inRange(textureTable, header.textureCount * sizeof(TextureRecord), size) ||
+        !inRange(lodTable, header.lodCount * sizeof(LodRecord), size)) {
+        return false;
+    }
+
+    const MeshRecord* meshRecords = reinterpret_cast<const MeshRecord*>(base + meshTable);
+    const TextureRecord* textureRecords = reinterpret_cast<const TextureRecord*>(base + textureTable);
+    const LodRecord* lodRecords = reinterpret_cast<const LodRecord*>(base + lodTable);
+
+    meshes.resize(header.meshCount);
+    for (uint32_t i = 0; i < header.meshCount; ++i) {
+        const MeshRecord& record = meshRecords[i];
+        if (!inRange(record.vertexOffset, (uint64_t)record.vertexCount * sizeof(Vertex), size) ||
+            !inRange(record.indexOffset, (uint64_t)record.indexCount * sizeof(unsigned int), size) ||
+            record.firstTexture + (uint64_t)record.textureCount > header.textureCount ||
+            record.firstLod + (uint64_t)record.lodCount > header.lodCount) {
+            meshes.clear();
+            return false;
+        }
+
+        MeshSource& mesh = meshes[i];
+        mesh.vertices = reinterpret_cast<const Vertex*>(base + record.vertexOffset);
+        mesh.vertexCount = record.vertexCount;
+        mesh.indices = reinterpret_cast<const unsigned int*>(base + record.indexOffset);
+        mesh.indexCount = record.indexCount;
+        mesh.baseColor = glm::vec3(record.baseColor[0], record.baseColor[1], record.baseColor[2]);
+        mesh.bounds = AABB(glm::vec3(record.boundsMin[0], record.boundsMin[1], record.boundsMin[2]),
+                           glm::vec3(record.boundsMax[0], record.boundsMax[1], record.boundsMax[2]));
+
+        for (uint32_t l = 0; l < record.lodCount; ++l) {
+            const LodRecord& lod = lodRecords[record.firstLod + l];
+            if (!inRange(lod.indexOffset, (uint64_t)lod.indexCount * sizeof(unsigned int), size)) {
+                meshes.clear();
+                return false;
+            }
+            LodSource source;
+            source.indices = reinterpret_cast<const unsigned int*>(base + lod.indexOffset);
+            source.indexCount = lod.indexCount;
+            source.error = lod.error;
+            mesh.lods.push_back(source);
+        }
+
+        for (uint32_t t = 0; t < record.textureCount; ++t) {
+            const TextureRecord& texture = textureRecords[record.firstTexture + t];
+            if (!inRange(texture.typeOffset, texture.typeLength, size) ||
+                !inRange(texture.pathOffset, texture.pathLength, size) ||
+                !inRange(texture.dataOffset, texture.dataSize, size)) {
+                meshes.clear();
+                return false;
+            }
+
+            TextureRef ref;
+            ref.type.assign(reinterpret_cast<const char*>(base + texture.typeOffset), texture.typeLength);
+            ref.path.assign(reinterpret_cast<const char*>(base + texture.pathOffset), texture.pathLength);
+            if (texture.dataSize) {
+                ref.embeddedData = base + texture.dataOffset;
+                ref.embeddedSize = texture.dataSize;
+            }
+            mesh.textures.push_back(ref);
+        }
+    }
+    return true;
+}
+
+bool MeshCache::write(const std::string& cachePath, uint32_t importFlags, uint64_t sourceHash,
+                      const std::vector<MeshSource>& meshes) {
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.importFlags = importFlags;
+    header.sourceHash = sourceHash;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.vertexSize = sizeof(Vertex);
+    for (const MeshSource& mesh : meshes) {
+        header.textureCount += static_cast<uint32_t>(mesh.textures.size());
+        header.lodCount += static_cast<uint32_t>(mesh.lods.size());
+    }
+
+    // Reserve the fixed-size tables, then append payloads and patch the records
+    ByteWriter writer;
+    writer.append(&header, sizeof(header));
+    uint64_t meshTable = writer.append(nullptr, meshes.size() * sizeof(MeshRecord));
+    uint64_t textureTable = writer.append(nullptr, header.textureCount * sizeof(TextureRecord));
+    uint64_t lodTable = writer.append(nullptr, header.lodCount * sizeof(LodRecord));
+
+    std::vector<MeshRecord> meshRecords(meshes.size());
+    std::vector<TextureRecord> textureRecords;
+    textureRecords.reserve(header.textureCount);
+    std::vector<LodRecord> lodRecords;
+    lodRecords.reserve(header.lodCount);
+
+    // Meshes sharing a material point at the same embedded image; store it once
+    std::unordered_map<const unsigned char*, uint64_t> blobOffsets;
+
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const MeshSource& mesh = meshes[i];
+        MeshRecord& record = meshRecords[i];
+        record.firstTexture = static_cast<uint32_t>(textureRecords.size());
+        record.textureCount = static_cast<uint32_t>(mesh.textures.size());
+        record.baseColor[0] = mesh.baseColor.r;
+        record.baseColor[1] = mesh.baseColor.g;
+        record.baseColor[2] = mesh.baseColor.b;
+        for (int k = 0; k < 3; ++k) {
+            record.boundsMin[k] = mesh.bounds.min[k];
+            record.boundsMax[k] = mesh.bounds.max[k];
+        }
+
+        for (const TextureRef& ref : mesh.textures) {
+            TextureRecord texture = {};
+            texture.typeOffset = writer.append(ref.type.data(), ref.type.size());
+            texture.typeLength = static_cast<uint32_t>(ref.type.size());
+            texture.pathOffset = writer.append(ref.path.data(), ref.path.size());
+            texture.pathLength = static_cast<uint32_t>(ref.path.size());
+            if (ref.embeddedSize) {
+                auto blob = blobOffsets.find(ref.embeddedData);
+                if (blob == blobOffsets.end())
+                    blob = blobOffsets.emplace(ref.embeddedData, writer.append(ref.embeddedData, ref.embeddedSize, 16)).first;
+                texture.dataOffset = blob->second;
+            }
+            texture.dataSize = ref.embeddedSize;
+            textureRecords.push_back(texture);
+        }
+    }
+
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const MeshSource& mesh = meshes[i];
+        MeshRecord& record = meshRecords[i];
+        record.vertexCount = static_cast<uint32_t>(mesh.vertexCount);
+        record.indexCount = static_cast<uint32_t>(mesh.indexCount);
+        record.vertexOffset = writer.append(mesh.vertices, mesh.vertexCount * sizeof(Vertex), 16);
+        record.indexOffset = writer.append(mesh.indices, mesh.indexCount * sizeof(unsigned int), 16);
+
+        record.firstLod = static_cast<uint32_t>(lodRecords.size());
+        record.lodCount = static_cast<uint32_t>(mesh.lods.size());
+        for (const LodSource& source : mesh.lods) {
+            LodRecord lod = {};
+            lod.indexOffset = writer.append(source.indices, source.indexCount * sizeof(unsigned int), 16);
+            lod.indexCount = static_cast<uint32_t>(source.indexCount);
+            lod.error = source.error;
+            lodRecords.push_back(lod);
+        }
+    }
+
+    header.fileSize = writer.bytes.size();
+    std::memcpy(writer.bytes.data(), &header, sizeof(header));
+    if (!meshRecords.empty())
+        std::memcpy(writer.bytes.data() + meshTable, meshRecords.data(), meshRecords.size() * sizeof(MeshRecord));
+    if (!textureRecords.empty())
+        std::memcpy(writer.bytes.data() + textureTable, textureRecords.data(), textureRecords.size() * sizeof(TextureRecord));
+    if (!lodRecords.empty())
+        std::memcpy(writer.bytes.data() + lodTable, lodRecords.data(), lodRecords.size() * sizeof(LodRecord));
+
+    // Write to a temporary name and rename, so readers never map a half-written file
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) return false;
+        stream.write(reinterpret_cast<const char*>(writer.bytes.data()), writer.bytes.size());
+        if (!stream) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,259 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// --- Forsyth vertex scoring ---
+// https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+const int kCacheSize = 32;
+const float kLastTriangleScore = 0.75f;
+const float kCacheDecayPower = 1.5f;
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+
+float vertexScore(int cachePosition, unsigned int remaining) {
+    if (remaining == 0) return -1.0f; // no triangles left: never worth picking
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        // The three vertices of the last triangle get a fixed score so they don't
+        // win purely by being most recent (keeps strips from turning back on themselves)
+        if (cachePosition < 3) {
+            score = kLastTriangleScore;
+        } else {
+            float scaler = 1.0f / (kCacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, kCacheDecayPower);
+        }
+    }
+    // Favour vertices with few triangles left so they get finished off instead of lingering
+    score += kValenceBoostScale * std::pow(static_cast<float>(remaining), -kValenceBoostPower);
+    return score;
+}
+
+glm::vec3 faceNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 u = b - a, v = c - a;
+    return glm::vec3(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x); // length = 2 * area
+}
+
+float length(const glm::vec3& v) {
+    return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+} // namespace
+
+float MeshOptimizer::acmr(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return 0.0f;
+
+    // FIFO: a vertex is cached if fewer than cacheSize misses happened since it was loaded
+    std::vector<unsigned int> loadedAt(vertexCount, 0);
+    unsigned int clock = static_cast<unsigned int>(cacheSize) + 1;
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (clock - loadedAt[index] > static_cast<unsigned int>(cacheSize)) {
+            loadedAt[index] = clock++;
+            ++misses;
+        }
+    }
+    return static_cast<float>(misses) / triangleCount;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) return;
+
+    // Per-vertex lists of triangles not emitted yet: [first[v], first[v] + remaining[v])
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (unsigned int index : indices) ++remaining[index];
+
+    std::vector<unsigned int> first(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) first[v + 1] = first[v] + remaining[v];
+
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> filled(vertexCount, 0);
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = indices[t * 3 + k];
+            adjacency[first[v] + filled[v]++] = static_cast<unsigned int>(t);
+        }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) score[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<char> emitted(triangleCount, 0);
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    std::vector<unsigned int> cache, nextCache;
+    cache.reserve(kCacheSize + 3);
+    nextCache.reserve(kCacheSize + 3);
+
+    size_t cursor = 0; // every triangle before this one has been emitted
+    long best = -1;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (best < 0) {
+            // Nothing in the cache is connected to what's left: restart at the next unemitted triangle
+            while (emitted[cursor]) ++cursor;
+            best = static_cast<long>(cursor);
+        }
+
+        const unsigned int* triangle = &indices[best * 3];
+        result.insert(result.end(), triangle, triangle + 3);
+        emitted[best] = 1;
+
+        // Drop the triangle from its vertices' lists
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = triangle[k];
+            unsigned int* list = &adjacency[first[v]];
+            for (unsigned int i = 0; i < remaining[v]; ++i) {
+                if (list[i] == static_cast<unsigned int>(best)) {
+                    std::swap(list[i], list[remaining[v] - 1]);
+                    break;
+                }
+            }
+            --remaining[v];
+        }
+
+        // LRU update: the triangle's vertices move to the front
+        nextCache.assign(triangle, triangle + 3);
+        for (unsigned int v : cache)
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) nextCache.push_back(v);
+
+        for (size_t i = 0; i < nextCache.size(); ++i) {
+            unsigned int v = nextCache[i];
+            cachePosition[v] = i < static_cast<size_t>(kCacheSize) ? static_cast<int>(i) : -1;
+            score[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+        if (nextCache.size() > static_cast<size_t>(kCacheSize)) nextCache.resize(kCacheSize);
+        cache.swap(nextCache);
+
+        // Rescore the triangles touching the cache and pick the best of them
+        best = -1;
+        float bestScore = -1.0f;
+        for (unsigned int v : cache) {
+            for (unsigned int i = 0; i < remaining[v]; ++i) {
+                unsigned int t = adjacency[first[v] + i];
+                const unsigned int* candidate = &indices[t * 3];
+                float s = score[candidate[0]] + score[candidate[1]] + score[candidate[2]];
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = static_cast<long>(t);
+                }
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float threshold) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) return;
+
+    float acmrBefore = acmr(indices, vertices.size());
+
+    // Clusters start where the cache-ordered sequence restarts (all three vertices miss),
+    // so moving whole clusters around costs little cache efficiency
+    std::vector<size_t> clusterStart;
+    {
+        const unsigned int cacheSize = 16;
+        std::vector<unsigned int> loadedAt(vertices.size(), 0);
+        unsigned int clock = cacheSize + 1;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            int misses = 0;
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = indices[t * 3 + k];
+                if (clock - loadedAt[v] > cacheSize) {
+                    loadedAt[v] = clock++;
+                    ++misses;
+                }
+            }
+            if (t == 0 || misses == 3) clusterStart.push_back(t);
+        }
+    }
+    size_t clusterCount = clusterStart.size();
+    if (clusterCount < 2) return;
+    clusterStart.push_back(triangleCount);
+
+    // Area-weighted centroids and normals
+    std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float clusterArea = 0.0f;
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; ++t) {
+            const glm::vec3& a = vertices[indices[t * 3]].Position;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].Position;
+            const glm::vec3& p = vertices[indices[t * 3 + 2]].Position;
+            glm::vec3 normal = faceNormal(a, b, p);
+            float area = length(normal);
+
+            clusterCentroid[c] += (a + b + p) * (area / 3.0f);
+            clusterNormal[c] += normal;
+            clusterArea += area;
+        }
+        meshCentroid += clusterCentroid[c];
+        meshArea += clusterArea;
+        if (clusterArea > 0.0f) clusterCentroid[c] /= clusterArea;
+    }
+    if (meshArea <= 0.0f) return;
+    meshCentroid /= meshArea;
+
+    // Clusters facing away from the middle of the mesh are likely in front: draw them first
+    std::vector<float> sortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float normalLength = length(clusterNormal[c]);
+        glm::vec3 offset = clusterCentroid[c] - meshCentroid;
+        sortKey[c] = normalLength > 0.0f
+            ? (offset.x * clusterNormal[c].x + offset.y * clusterNormal[c].y + offset.z * clusterNormal[c].z) / normalLength
+            : 0.0f;
+    }
+
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) order[c] = c;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (size_t c : order)
+        result.insert(result.end(), indices.begin() + clusterStart[c] * 3, indices.begin() + clusterStart[c + 1] * 3);
+
+    // Overdraw only matters if it doesn't undo the cache ordering
+    if (acmr(result, vertices.size()) <= acmrBefore * threshold)
+        indices.swap(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(vertices.size(), unused);
+    unsigned int next = 0;
+
+    for (unsigned int& index : indices) {
+        if (remap[index] == unused) remap[index] = next++;
+        index = remap[index];
+    }
+
+    std::vector<Vertex> reordered(next);
+    for (size_t v = 0; v < vertices.size(); ++v)
+        if (remap[v] != unused) reordered[remap[v]] = vertices[v];
+    vertices.swap(reordered);
+}
+
+MeshOptimizer::Stats MeshOptimizer::optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, float threshold) {
+    Stats stats;
+    stats.acmrBefore = acmr(indices, vertices.size());
+
+    optimizeVertexCache(indices, vertices.size());
+    optimizeOverdraw(indices, vertices, threshold);
+    optimizeVertexFetch(vertices, indices);
+
+    stats.acmrAfter = acmr(indices, vertices.size());
+    return stats;
+}
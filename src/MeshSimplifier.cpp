@@ -0,0 +1,267 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// Symmetric 4x4 error quadric of a set of planes: Q(p) = sum of squared distances to them
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+
+    void addPlane(double a, double b, double c, double d, double weight) {
+        a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+        b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+        c2 += weight * c * c; cd += weight * c * d;
+        d2 += weight * d * d;
+    }
+
+    void add(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+    }
+
+    double evaluate(const glm::vec3& p, double weight) const {
+        double x = p.x, y = p.y, z = p.z;
+        double error = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                     + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                     + c2 * z * z + 2 * cd * z
+                     + d2;
+        return weight > 0 ? std::max(error, 0.0) / weight : 0.0; // area-weighted mean squared distance
+    }
+};
+
+struct Collapse {
+    unsigned int from, to;
+    double cost;
+};
+
+glm::vec3 cross(const glm::vec3& u, const glm::vec3& v) {
+    return glm::vec3(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+}
+
+float dot(const glm::vec3& u, const glm::vec3& v) {
+    return u.x * v.x + u.y * v.y + u.z * v.z;
+}
+
+uint64_t edgeKey(unsigned int a, unsigned int b) {
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+// Vertices sharing a position map to the lowest such index
+std::vector<unsigned int> weldPositions(const Vertex* vertices, size_t vertexCount) {
+    struct PositionHash {
+        size_t operator()(const glm::vec3& p) const {
+            uint32_t bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+        }
+    };
+    struct PositionEqual {
+        bool operator()(const glm::vec3& a, const glm::vec3& b) const { return a.x == b.x && a.y == b.y && a.z == b.z; }
+    };
+
+    std::unordered_map<glm::vec3, unsigned int, PositionHash, PositionEqual> first;
+    first.reserve(vertexCount);
+    std::vector<unsigned int> weld(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        weld[v] = first.emplace(vertices[v].Position, static_cast<unsigned int>(v)).first->second;
+    return weld;
+}
+
+} // namespace
+
+std::vector<unsigned int> MeshSimplifier::simplify(const Vertex* vertices, size_t vertexCount, const std::vector<unsigned int>& indices,
+                                                   size_t targetIndexCount, float maxError, float& resultError) {
+    resultError = 0.0f;
+    std::vector<unsigned int> result = indices;
+    if (result.size() <= targetIndexCount || result.size() % 3 != 0) return result;
+
+    // 1. Locked vertices: attribute seams, open borders and non-manifold edges
+    std::vector<unsigned int> weld = weldPositions(vertices, vertexCount);
+    std::vector<unsigned int> groupSize(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v) ++groupSize[weld[v]];
+
+    std::vector<char> lockedGroup(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        if (groupSize[weld[v]] > 1) lockedGroup[weld[v]] = 1;
+
+    std::unordered_map<uint64_t, int> edgeUse;
+    edgeUse.reserve(result.size());
+    for (size_t i = 0; i < result.size(); i += 3)
+        for (int k = 0; k < 3; ++k)
+            ++edgeUse[edgeKey(weld[result[i + k]], weld[result[i + (k + 1) % 3]])];
+    for (const auto& edge : edgeUse) {
+        if (edge.second == 2) continue;
+        lockedGroup[edge.first >> 32] = 1;
+        lockedGroup[edge.first & 0xFFFFFFFFu] = 1;
+    }
+
+    // 2. Area-weighted plane quadrics
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<double> weights(vertexCount, 0.0);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const glm::vec3& p0 = vertices[result[i]].Position;
+        glm::vec3 normal = cross(vertices[result[i + 1]].Position - p0, vertices[result[i + 2]].Position - p0);
+        double length = std::sqrt(dot(normal, normal));
+        if (length <= 0.0) continue;
+
+        double a = normal.x / length, b = normal.y / length, c = normal.z / length;
+        double d = -(a * p0.x + b * p0.y + c * p0.z);
+        double area = 0.5 * length;
+        for (int k = 0; k < 3; ++k) {
+            quadrics[result[i + k]].addPlane(a, b, c, d, area);
+            weights[result[i + k]] += area;
+        }
+    }
+
+    double maxCost = double(maxError) * maxError;
+    double worstCost = 0.0;
+
+    std::vector<Collapse> collapses;
+    std::vector<unsigned int> triangleStart(vertexCount + 1), triangleList, filled(vertexCount);
+    std::vector<char> touched(vertexCount);
+
+    // 3. Passes of independent collapses, cheapest first, until the target or the error bound
+    while (result.size() > targetIndexCount) {
+        size_t triangleCount = result.size() / 3;
+
+        // Vertex -> triangle adjacency for the flip test
+        std::fill(triangleStart.begin(), triangleStart.end(), 0);
+        for (unsigned int index : result) ++triangleStart[index + 1];
+        for (size_t v = 0; v < vertexCount; ++v) triangleStart[v + 1] += triangleStart[v];
+        triangleList.resize(result.size());
+        std::fill(filled.begin(), filled.end(), 0);
+        for (size_t t = 0; t < triangleCount; ++t)
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = result[t * 3 + k];
+                triangleList[triangleStart[v] + filled[v]++] = static_cast<unsigned int>(t);
+            }
+
+        // Cheaper direction of every edge whose source may move
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                unsigned int a = result[i + k], b = result[i + (k + 1) % 3];
+                if (a > b) continue; // each edge once (the other winding visits it the other way round)
+
+                Collapse best = { a, b, -1.0 };
+                for (int direction = 0; direction < 2; ++direction) {
+                    unsigned int from = direction == 0 ? a : b, to = direction == 0 ? b : a;
+                    if (lockedGroup[weld[from]]) continue;
+
+                    Quadric q = quadrics[from];
+                    q.add(quadrics[to]);
+                    double cost = q.evaluate(vertices[to].Position, weights[from] + weights[to]);
+                    if (best.cost < 0.0 || cost < best.cost) best = { from, to, cost };
+                }
+                if (best.cost >= 0.0 && best.cost <= maxCost) collapses.push_back(best);
+            }
+        }
+        if (collapses.empty()) break;
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        std::vector<unsigned int> remap(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) remap[v] = static_cast<unsigned int>(v);
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t removedTriangles = 0;
+        size_t wantedTriangles = (result.size() - targetIndexCount + 2) / 3;
+        size_t applied = 0;
+
+        for (const Collapse& collapse : collapses) {
+            if (touched[collapse.from] || touched[collapse.to]) continue;
+
+            // Reject collapses that flip or crush a neighbouring triangle
+            const glm::vec3& target = vertices[collapse.to].Position;
+            bool valid = true;
+            size_t shared = 0;
+            for (unsigned int i = triangleStart[collapse.from]; i < triangleStart[collapse.from + 1] && valid; ++i) {
+                const unsigned int* triangle = &result[triangleList[i] * 3];
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                    ++shared;
+                    continue;
+                }
+                glm::vec3 p[3], q[3];
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = vertices[triangle[k]].Position;
+                    q[k] = triangle[k] == collapse.from ? target : p[k];
+                }
+                glm::vec3 before = cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 after = cross(q[1] - q[0], q[2] - q[0]);
+                float lengths = std::sqrt(dot(before, before) * dot(after, after));
+                valid = lengths > 0.0f && dot(before, after) > 0.25f * lengths;
+            }
+            if (!valid) continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            weights[collapse.to] += weights[collapse.from];
+            worstCost = std::max(worstCost, collapse.cost);
+
+            // The one-ring changed shape: its vertices wait for the next pass
+            for (unsigned int i = triangleStart[collapse.from]; i < triangleStart[collapse.from + 1]; ++i) {
+                const unsigned int* triangle = &result[triangleList[i] * 3];
+                touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+            }
+
+            ++applied;
+            removedTriangles += shared;
+            if (removedTriangles >= wantedTriangles) break;
+        }
+        if (applied == 0) break;
+
+        // Rewrite and drop the triangles that collapsed to an edge
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            unsigned int a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if (a == b || b == c || a == c) continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    resultError = static_cast<float>(std::sqrt(worstCost));
+    return result;
+}
+
+std::vector<LodLevel> MeshSimplifier::buildLodChain(const Vertex* vertices, size_t vertexCount, const std::vector<unsigned int>& indices,
+                                                    int maxLevels, float reduction, float maxRelativeError) {
+    std::vector<LodLevel> levels;
+    if (vertexCount == 0 || indices.size() < 3 * 64) return levels; // too small to be worth it
+
+    glm::vec3 boundsMin = vertices[0].Position, boundsMax = vertices[0].Position;
+    for (size_t v = 1; v < vertexCount; ++v) {
+        boundsMin = glm::min(boundsMin, vertices[v].Position);
+        boundsMax = glm::max(boundsMax, vertices[v].Position);
+    }
+    glm::vec3 extent = boundsMax - boundsMin;
+    float maxError = maxRelativeError * std::sqrt(dot(extent, extent));
+
+    size_t previousCount = indices.size();
+    float target = static_cast<float>(indices.size());
+    for (int level = 0; level < maxLevels; ++level) {
+        target *= reduction;
+
+        LodLevel lod;
+        lod.indices = simplify(vertices, vertexCount, indices, static_cast<size_t>(target) / 3 * 3, maxError, lod.error);
+
+        // Stuck at the error bound: coarser levels would look the same
+        if (lod.indices.size() < 3 * 16 || lod.indices.size() > previousCount * 0.8f) break;
+
+        MeshOptimizer::optimizeVertexCache(lod.indices, vertexCount);
+        previousCount = lod.indices.size();
+        levels.push_back(std::move(lod));
+    }
+    return levels;
+}
@@ -1,47 +1,278 @@
 #include "Model.h"
+#include "MeshOptimizer.h"
+#include "VertexPacking.h"
+#include <algorithm>
 #include <iostream>
-#include <stb_image.h> 
 
-// Forward declaration
-unsigned int LoadTexture(const char *path, const std::string &directory, const aiScene* scene);
+std::atomic<bool> Model::packedVertices{true};
 
 Model::Model(const std::string& path) {
-    loadModel(path);
+    ModelData data;
+    if (!Import(path, data)) return;
+
+    directory = data.directory;
+    for (size_t i = 0; i < data.meshes.size(); i++)
+        UploadMesh(data, i);
 }
 
-void Model::Draw(unsigned int shaderProgram) {
-    for(unsigned int i = 0; i < meshes.size(); i++)
-        meshes[i].Draw(shaderProgram);
+Model::~Model() {
+    if (residency) ResidencyManager::instance().untrack(residency);
 }
 
-void Model::loadModel(const std::string& path) {
-    Assimp::Importer importer;
+void Model::Submit(RenderQueue& queue, Shader& shader, const glm::mat4& transform, int lod) const {
+    // Drawn this frame: last in line for eviction, and brought back if it was evicted
+    if (residency) ResidencyManager::instance().touch(residency);
+
+    for (const MeshBatch& batch : batches) {
+        const Mesh& mesh = meshes[batch.mesh];
+        const DrawRanges& ranges = batch.lods[std::min(std::max(lod, 0), static_cast<int>(batch.lods.size()) - 1)];
+
+        DrawPacket packet;
+        packet.shader = &shader;
+        packet.material = &mesh.GetMaterial();
+        packet.VAO = mesh.GetVAO();
+        packet.drawCount = static_cast<GLsizei>(ranges.counts.size());
+        packet.counts = ranges.counts.data();
+        packet.indexOffsets = ranges.indexOffsets.data();
+        packet.baseVertices = ranges.baseVertices.data();
+        packet.indexType = mesh.GetIndexType();
+
+        ObjectUniforms object = UniformBuffers::MakeObject(transform, mesh.baseColor, mesh.hasTexture);
+        if (mesh.GetVertexFormat() == VertexFormat::Packed) {
+            object.positionScale = glm::vec4(positionScale, 1.0f);
+            object.positionBias = glm::vec4(positionBias, 0.0f);
+        }
+        queue.Add(packet, object);
+    }
+}
+
+void Model::buildBatches() {
+    batches.clear();
+    int lodCount = 1;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const Mesh& mesh = meshes[i];
+        const GeometryAllocation& geometry = mesh.GetGeometry();
+        if (!geometry.IsValid() || geometry.indexCount == 0) continue;
+
+        // Same VAO, same textures and the same ObjectData: one draw range more in an existing batch
+        MeshBatch* batch = nullptr;
+        for (MeshBatch& candidate : batches) {
+            const Mesh& first = meshes[candidate.mesh];
+            if (first.GetVAO() == mesh.GetVAO() && first.GetMaterial().SameAs(mesh.GetMaterial()) &&
+                first.hasTexture == mesh.hasTexture && first.baseColor == mesh.baseColor) {
+                batch = &candidate;
+                break;
+            }
+        }
+        if (!batch) {
+            batches.push_back(MeshBatch());
+            batch = &batches.back();
+            batch->mesh = i;
+        }
+        batch->members.push_back(i);
+        lodCount = std::max(lodCount, mesh.GetLodCount());
+    }
+
+    // Every batch gets every level; meshes with a shorter chain repeat their coarsest one
+    lodErrors.assign(lodCount, 0.0f);
+    for (MeshBatch& batch : batches) {
+        batch.lods.assign(lodCount, DrawRanges());
+        for (int level = 0; level < lodCount; ++level) {
+            DrawRanges& ranges = batch.lods[level];
+            for (size_t member : batch.members) {
+                const Mesh& mesh = meshes[member];
+                const GeometryAllocation& range = mesh.GetLod(level);
+                size_t indexSize = mesh.GetIndexType() == GL_UNSIGNED_SHORT ? 2 : 4;
+                ranges.counts.push_back(range.indexCount);
+                ranges.indexOffsets.push_back((const void*)(size_t(range.firstIndex) * indexSize));
+                ranges.baseVertices.push_back(range.baseVertex);
+                lodErrors[level] = std::max(lodErrors[level], mesh.GetLodError(level));
+            }
+        }
+    }
+    // Selection expects errors to grow with the level
+    for (int level = 1; level < lodCount; ++level)
+        lodErrors[level] = std::max(lodErrors[level], lodErrors[level - 1]);
+}
+
+bool Model::Import(const std::string& path, ModelData& data) {
     // Standard flags for game dev + GenSmoothNormals from your baseline
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    const unsigned int importFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+
+    data.directory = path.substr(0, path.find_last_of('/'));
+
+    // 1. Binary mesh cache: the arrays stay in the mapping and are uploaded from there
+    uint64_t sourceHash = 0;
+    bool hashed = MeshCache::hashSource(path, sourceHash);
+    std::string cachePath = MeshCache::pathFor(path);
+
+    if (hashed) {
+        auto mapping = std::make_shared<MappedFile>();
+        if (MeshCache::read(cachePath, importFlags, sourceHash, *mapping, data.meshes)) {
+            data.mapping = mapping;
+            decodeTextures(data);
+            compactMeshes(data);
+            return true;
+        }
+    }
+
+    // 2. Cache miss: import and write the cache
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, importFlags);
 
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
-        return;
+        return false;
+    }
+
+    processNode(scene->mRootNode, scene, data.storage);
+
+    data.meshes.clear();
+    for (const MeshData& mesh : data.storage) {
+        MeshSource source;
+        source.vertices = mesh.vertices.data();
+        source.vertexCount = mesh.vertices.size();
+        source.indices = mesh.indices.data();
+        source.indexCount = mesh.indices.size();
+        source.baseColor = mesh.baseColor;
+        source.bounds = mesh.bounds;
+        source.textures = mesh.textures;
+        for (const LodLevel& level : mesh.lods)
+            source.lods.push_back({ level.indices.data(), level.indices.size(), level.error });
+        data.meshes.push_back(std::move(source));
     }
 
-    directory = path.substr(0, path.find_last_of('/'));
-    processNode(scene->mRootNode, scene);
+    if (hashed && !MeshCache::write(cachePath, importFlags, sourceHash, data.meshes))
+        std::cout << "ERROR::MESHCACHE::WRITE_FAILED " << cachePath << std::endl;
+
+    // Embedded texture bytes live in the aiScene: decode them before the importer goes away
+    decodeTextures(data);
+    for (MeshSource& mesh : data.meshes) {
+        for (TextureRef& ref : mesh.textures) {
+            ref.embeddedData = nullptr;
+            ref.embeddedSize = 0;
+        }
+    }
+    compactMeshes(data);
+    return true;
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene) {
+bool Model::computeBounds(ModelData& data) {
+    // Per-mesh boxes come from the import (or the mesh cache): no pass over the vertices
+    data.bounds = AABB();
+    for (const MeshSource& mesh : data.meshes)
+        if (mesh.bounds.IsValid()) data.bounds.Expand(mesh.bounds);
+    return data.bounds.IsValid();
+}
+
+void Model::compactMeshes(ModelData& data) {
+    data.compact.assign(data.meshes.size(), CompactMeshData());
+    bool hasBounds = computeBounds(data);
+
+    // 16-bit indices whenever they fit, in either vertex format
+    for (size_t i = 0; i < data.meshes.size(); ++i) {
+        const MeshSource& mesh = data.meshes[i];
+        if (!VertexPacking::fitsShortIndices(mesh.vertexCount)) continue;
+
+        data.compact[i].indices = VertexPacking::shortIndices(mesh.indices, mesh.indexCount);
+        for (const LodSource& lod : mesh.lods)
+            data.compact[i].lodIndices.push_back(VertexPacking::shortIndices(lod.indices, lod.indexCount));
+    }
+
+    if (!UsesPackedVertices() || !hasBounds) return;
+
+    // One box around every mesh, so the whole model dequantizes with one scale/bias
+    VertexPacking::quantization(data.bounds.min, data.bounds.max, data.positionScale, data.positionBias);
+    for (size_t i = 0; i < data.meshes.size(); ++i) {
+        const MeshSource& mesh = data.meshes[i];
+        std::vector<PackedVertex>& packed = data.compact[i].vertices;
+        packed.resize(mesh.vertexCount);
+        for (size_t v = 0; v < mesh.vertexCount; ++v)
+            packed[v] = VertexPacking::pack(mesh.vertices[v], data.positionScale, data.positionBias);
+    }
+}
+
+void Model::UploadMesh(const ModelData& data, size_t index) {
+    const MeshSource& source = data.meshes[index];
+    const CompactMeshData* compact = index < data.compact.size() ? &data.compact[index] : nullptr;
+
+    bool packed = compact && !compact->vertices.empty();
+    bool shortIndices = compact && !compact->indices.empty();
+    if (packed) {
+        positionScale = data.positionScale;
+        positionBias = data.positionBias;
+    }
+
+    meshes.emplace_back(packed ? VertexFormat::Packed : VertexFormat::Standard,
+                        packed ? (const void*)compact->vertices.data() : (const void*)source.vertices, source.vertexCount,
+                        shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                        shortIndices ? (const void*)compact->indices.data() : (const void*)source.indices, source.indexCount,
+                        loadTextures(source.textures, data), source.baseColor);
+    meshes.back().bounds = source.bounds;
+    bounds.Expand(source.bounds);
+
+    // Coarser index lists over the same vertex range
+    for (size_t level = 0; level < source.lods.size(); ++level) {
+        const LodSource& lod = source.lods[level];
+        meshes.back().AddLod(shortIndices ? (const void*)compact->lodIndices[level].data() : (const void*)lod.indices,
+                             lod.indexCount, lod.error);
+    }
+    buildBatches();
+    reportResidency();
+}
+
+void Model::Evict() {
+    meshes.clear(); // returns the pool ranges and drops the texture handles
+    batches.clear();
+    reportResidency();
+}
+
+size_t Model::GetCpuBytes() const {
+    size_t bytes = cpuData ? GetCpuBytes(*cpuData) : 0;
+    for (const Mesh& mesh : meshes) bytes += mesh.GetCpuBytes();
+    return bytes;
+}
+
+size_t Model::GetGpuBytes() const {
+    size_t bytes = 0;
+    for (const Mesh& mesh : meshes) bytes += mesh.GetGpuBytes();
+    return bytes;
+}
+
+size_t Model::GetCpuBytes(const ModelData& data) {
+    size_t bytes = data.mapping ? data.mapping->size() : 0;
+    for (const MeshData& mesh : data.storage) {
+        bytes += mesh.vertices.capacity() * sizeof(Vertex) + mesh.indices.capacity() * sizeof(unsigned int);
+        for (const LodLevel& level : mesh.lods) bytes += level.indices.capacity() * sizeof(unsigned int);
+    }
+    for (const CompactMeshData& compact : data.compact) {
+        bytes += compact.vertices.capacity() * sizeof(PackedVertex) + compact.indices.capacity() * sizeof(uint16_t);
+        for (const std::vector<uint16_t>& lod : compact.lodIndices) bytes += lod.capacity() * sizeof(uint16_t);
+    }
+    for (const auto& image : data.images) bytes += image.second.bytes();
+    return bytes;
+}
+
+void Model::reportResidency() const {
+    if (residency) ResidencyManager::instance().setBytes(residency, GetCpuBytes(), GetGpuBytes());
+}
+
+void Model::processNode(aiNode* node, const aiScene* scene, std::vector<MeshData>& out) {
     for(unsigned int i = 0; i < node->mNumMeshes; i++) {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes.push_back(processMesh(mesh, scene));
+        out.push_back(processMesh(mesh, scene));
     }
     for(unsigned int i = 0; i < node->mNumChildren; i++) {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], scene, out);
     }
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene) {
+    MeshData data;
+    std::vector<Vertex>& vertices = data.vertices;
+    std::vector<unsigned int>& indices = data.indices;
+    vertices.reserve(mesh->mNumVertices);
+    indices.reserve(mesh->mNumFaces * 3);
 
     // 1. Process Vertices
     for(unsigned int i = 0; i < mesh->mNumVertices; i++) {
@@ -70,152 +301,128 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
         }
 
         vertices.push_back(vertex);
+        data.bounds.Expand(vertex.Position);
     }
 
     // 2. Process Indices
+    bool trianglesOnly = true; // Triangulate still lets points and lines through
     for(unsigned int i = 0; i < mesh->mNumFaces; i++) {
         aiFace face = mesh->mFaces[i];
+        trianglesOnly = trianglesOnly && face.mNumIndices == 3;
         for(unsigned int j = 0; j < face.mNumIndices; j++)
             indices.push_back(face.mIndices[j]);
     }
 
+    // Reorder for the post-transform cache, overdraw and vertex fetch. Once per asset: the mesh cache keeps the result
+    if (trianglesOnly && !indices.empty()) {
+        MeshOptimizer::Stats stats = MeshOptimizer::optimize(vertices, indices);
+        std::cout << "Optimized mesh '" << mesh->mName.C_Str() << "' (" << indices.size() / 3 << " triangles): ACMR "
+                  << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+
+        // LOD chain over the optimized vertex order; cached along with the mesh
+        data.lods = MeshSimplifier::buildLodChain(vertices.data(), vertices.size(), indices);
+        if (!data.lods.empty()) {
+            std::cout << "Simplified mesh '" << mesh->mName.C_Str() << "':";
+            for (const LodLevel& level : data.lods)
+                std::cout << " " << level.indices.size() / 3 << " (error " << level.error << ")";
+            std::cout << std::endl;
+        }
+    }
+
     // 3. Process Materials
     if (mesh->mMaterialIndex >= 0) {
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+
+        // Fallback color for untextured meshes (OBJ Kd; glTF baseColorFactor is mapped here too)
+        aiColor4D color;
+        if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS)
+            data.baseColor = glm::vec3(color.r, color.g, color.b);
         
         // 1. Diffuse maps
-        std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", scene);
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+        collectMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", scene, data.textures);
         
         // 2. Specular maps
-        std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", scene);
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        collectMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", scene, data.textures);
 
         // 3. Normal maps (obj uses height, gltf uses normals)
-        std::vector<Texture> normalMaps = loadMaterialTextures(material, aiTextureType_NORMALS, "texture_normal", scene);
-        textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
+        collectMaterialTextures(material, aiTextureType_NORMALS, "texture_normal", scene, data.textures);
         
         // 4. Base Color (PBR workflow used by GLTF/GLB - often used instead of diffuse)
-        std::vector<Texture> baseColorMaps = loadMaterialTextures(material, aiTextureType_BASE_COLOR, "texture_diffuse", scene);
-        textures.insert(textures.end(), baseColorMaps.begin(), baseColorMaps.end());
+        collectMaterialTextures(material, aiTextureType_BASE_COLOR, "texture_diffuse", scene, data.textures);
     }
 
-    return Mesh(vertices, indices, textures);
+    return data;
 }
 
-std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName, const aiScene* scene) {
-    std::vector<Texture> textures;
+void Model::collectMaterialTextures(aiMaterial *mat, aiTextureType type, const std::string& typeName, const aiScene* scene, std::vector<TextureRef>& out) {
     for(unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
         aiString str;
         mat->GetTexture(type, i, &str);
-        
-        bool skip = false;
-        for(unsigned int j = 0; j < textures_loaded.size(); j++) {
-            if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0) {
-                textures.push_back(textures_loaded[j]);
-                skip = true;
-                break;
+
+        TextureRef ref;
+        ref.type = typeName;
+        ref.path = str.C_Str();
+
+        // If path starts with '*', it's an index into the scene's internal texture array (GLB).
+        // Keep a pointer to the bytes so they can be decoded now or stored in the mesh cache.
+        if (!ref.path.empty() && ref.path[0] == '*') {
+            unsigned int index = static_cast<unsigned int>(std::stoi(ref.path.substr(1)));
+            if (index < scene->mNumTextures) {
+                const aiTexture* embeddedTexture = scene->mTextures[index];
+                ref.embeddedData = reinterpret_cast<const unsigned char*>(embeddedTexture->pcData);
+                // mHeight is 0 when the texture is compressed (JPG/PNG); otherwise raw ARGB8888 texels
+                ref.embeddedSize = embeddedTexture->mHeight == 0
+                    ? embeddedTexture->mWidth
+                    : embeddedTexture->mWidth * embeddedTexture->mHeight * sizeof(aiTexel);
             }
         }
-        
-        if(!skip) {
-            Texture texture;
-            texture.id = LoadTexture(str.C_Str(), this->directory, scene);
-            texture.type = typeName;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            textures_loaded.push_back(texture);
-        }
+        out.push_back(std::move(ref));
     }
-    return textures;
 }
 
-// --- Robust Texture Loader (Handles Files AND Embedded GLB) ---
-unsigned int LoadTexture(const char *path, const std::string &directory, const aiScene* scene) {
-    std::string filename = std::string(path);
-    
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = nullptr;
-
-    // --- CHECK 1: EMBEDDED TEXTURE (GLB) ---
-    // If path starts with '*', it's an index into the scene's internal texture array
-    if (filename[0] == '*') {
-        // Do NOT flip embedded textures. They are usually aligned with the model's internal UVs already.
-        stbi_set_flip_vertically_on_load(false); 
-
-        int index = std::stoi(filename.substr(1));
-        if (index < scene->mNumTextures) {
-            const aiTexture* embeddedTexture = scene->mTextures[index];
-            
-            // Case A: Compressed (JPG/PNG) embedded data
-            // mHeight is 0 when the texture is compressed
-            if (embeddedTexture->mHeight == 0) {
-                data = stbi_load_from_memory(
-                    reinterpret_cast<unsigned char*>(embeddedTexture->pcData),
-                    embeddedTexture->mWidth,
-                    &width, &height, &nrComponents, 0
-                );
-            } 
-            // Case B: Raw pixel data (ARGB8888)
-            else {
-                data = stbi_load_from_memory(
-                    reinterpret_cast<unsigned char*>(embeddedTexture->pcData),
-                    embeddedTexture->mWidth * embeddedTexture->mHeight, 
-                    &width, &height, &nrComponents, 0
-                );
+void Model::decodeTextures(ModelData& data) {
+    TextureCache& cache = TextureCache::instance();
+    for (MeshSource& mesh : data.meshes) {
+        for (TextureRef& ref : mesh.textures) {
+            ref.cacheKey = TextureCache::keyFor(ref.path, data.directory, ref.embeddedData, ref.embeddedSize);
+            if (data.images.count(ref.cacheKey) || data.cached.count(ref.cacheKey)) continue;
+
+            // Already uploaded by another model: hold it so it can't be released before our upload
+            if (TextureHandle existing = cache.find(ref.cacheKey)) {
+                data.cached[ref.cacheKey] = existing;
+                continue;
+            }
+
+            // Baked container (.ttex) or decode + bake. Failures are stored too, so each texture is only attempted once
+            bool embedded = !ref.path.empty() && ref.path[0] == '*';
+            if (embedded) {
+                // Do NOT flip embedded textures. They are usually aligned with the model's internal UVs already.
+                data.images[ref.cacheKey] = ref.embeddedData
+                    ? TextureCache::loadEmbedded(ref.embeddedData, ref.embeddedSize, false)
+                    : ImageData();
+            } else {
+                // ENABLE flipping for external files because we used aiProcess_FlipUVs
+                data.images[ref.cacheKey] = TextureCache::loadFile(data.directory + '/' + ref.path, true);
             }
         }
-    } 
-    // --- CHECK 2: EXTERNAL FILE (OBJ/DAE) ---
-    else {
-        // ENABLE flipping for external files because we used aiProcess_FlipUVs
-        stbi_set_flip_vertically_on_load(true);
-        
-        filename = directory + '/' + filename;
-        data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
     }
+}
 
-    if (data) {
-        GLenum format;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // Wrapping: Repeat ensures we don't get ugly edges if UVs go out of bounds
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        // Filtering: Linear Mipmap Linear is the highest quality standard filtering
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // 1. Manually define the constants if the header is missing them
-        #ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
-        #define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
-        #define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
-        #endif
-
-        // 2. Query and Apply (No #ifdef check, just run it)
-        GLfloat maxAnisotropy = 0.0f;
-        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+std::vector<Texture> Model::loadTextures(const std::vector<TextureRef>& refs, const ModelData& data) {
+    // Shared across all models; duplicates are found by key, not by scanning
+    TextureCache& cache = TextureCache::instance();
 
-        // Clamp to 16.0f (or whatever the GPU supports) and apply
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(16.0f, maxAnisotropy));
+    std::vector<Texture> textures;
+    textures.reserve(refs.size());
+    for (const TextureRef& ref : refs) {
+        auto image = data.images.find(ref.cacheKey);
 
-        stbi_image_free(data);
-    } else {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
+        Texture texture;
+        texture.handle = cache.acquire(ref.cacheKey, image != data.images.end() ? image->second : ImageData());
+        texture.id = texture.handle->id;
+        texture.type = ref.type;
+        texture.path = ref.path;
+        textures.push_back(std::move(texture));
     }
-
-    // Reset global state to safe default
-    stbi_set_flip_vertically_on_load(false);
-
-    return textureID;
-}
\ No newline at end of file
+    return textures;
+}
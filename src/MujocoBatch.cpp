@@ -0,0 +1,98 @@
+#include "MujocoBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+MujocoBatch::MujocoBatch(const MujocoSim& sim, int numEnvs, unsigned int numThreads)
+    : m_(sim.getModel())
+{
+    if (!m_) {
+        throw std::runtime_error("MujocoBatch: the source MujocoSim has no model loaded.");
+    }
+    if (numEnvs <= 0) {
+        throw std::runtime_error("MujocoBatch: numEnvs must be positive.");
+    }
+
+    data_.reserve(numEnvs);
+    for (int i = 0; i < numEnvs; ++i) {
+        mjData* d = mj_makeData(m_);
+        if (!d) {
+            for (mjData* created : data_) mj_deleteData(created);
+            data_.clear();
+            throw std::runtime_error("Failed to create MuJoCo data structure for batch environment.");
+        }
+        data_.push_back(d);
+    }
+
+    // The calling thread takes a chunk in parallelFor, so it counts as one of the threads
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (numThreads > 1)
+        pool_ = std::make_unique<ThreadPool>(numThreads - 1);
+
+    qpos_.resize(static_cast<size_t>(numEnvs) * m_->nq);
+    qvel_.resize(static_cast<size_t>(numEnvs) * m_->nv);
+    time_.resize(numEnvs);
+
+    reset();
+}
+
+MujocoBatch::~MujocoBatch() {
+    pool_.reset();
+    for (mjData* d : data_)
+        mj_deleteData(d);
+}
+
+void MujocoBatch::gatherState(int env) {
+    const mjData* d = data_[env];
+    std::memcpy(&qpos_[static_cast<size_t>(env) * m_->nq], d->qpos, m_->nq * sizeof(mjtNum));
+    std::memcpy(&qvel_[static_cast<size_t>(env) * m_->nv], d->qvel, m_->nv * sizeof(mjtNum));
+    time_[env] = d->time;
+}
+
+void MujocoBatch::forEachRange(const std::function<void(int, int)>& fn) {
+    if (pool_) pool_->parallelFor(getNumEnvs(), fn);
+    else       fn(0, getNumEnvs());
+}
+
+void MujocoBatch::step(const mjtNum* ctrl, int substeps) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Each worker owns a contiguous range of environments: controls in, steps, state out
+    forEachRange([&](int begin, int end) {
+        for (int env = begin; env < end; ++env) {
+            mjData* d = data_[env];
+            if (ctrl && m_->nu > 0)
+                std::memcpy(d->ctrl, ctrl + static_cast<size_t>(env) * m_->nu, m_->nu * sizeof(mjtNum));
+            for (int s = 0; s < substeps; ++s)
+                mj_step(m_, d);
+            gatherState(env);
+        }
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long steps = static_cast<long long>(getNumEnvs()) * substeps;
+    totalSteps_ += steps;
+    stepsPerSecond_ = seconds > 0.0 ? steps / seconds : 0.0;
+}
+
+void MujocoBatch::setControls(const mjtNum* ctrl) {
+    if (!ctrl || m_->nu == 0) return;
+    for (int env = 0; env < getNumEnvs(); ++env)
+        std::memcpy(data_[env]->ctrl, ctrl + static_cast<size_t>(env) * m_->nu, m_->nu * sizeof(mjtNum));
+}
+
+void MujocoBatch::reset(const unsigned char* mask, int keyframe) {
+    if (keyframe >= m_->nkey) keyframe = -1;
+
+    forEachRange([&](int begin, int end) {
+        for (int env = begin; env < end; ++env) {
+            if (mask && !mask[env]) continue;
+            if (keyframe >= 0) mj_resetDataKeyframe(m_, data_[env], keyframe);
+            else               mj_resetData(m_, data_[env]);
+            mj_forward(m_, data_[env]);
+            gatherState(env);
+        }
+    });
+}
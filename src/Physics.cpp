@@ -1,6 +1,22 @@
 #include "Physics.h"
+#include "FileSystem.h"
+#include "Hash.h"
 #include <iostream>
 #include <cstring>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TOON_POSE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define TOON_POSE_NEON
+#endif
 
 MujocoSim::MujocoSim() {
     // Optional: Set your MuJoCo license path if using an older version
@@ -11,12 +27,159 @@ MujocoSim::~MujocoSim() {
     cleanup();
 }
 
+// --- Compiled Model Cache ---
+
+// Directories assets are resolved against, from <compiler meshdir/texturedir/assetdir>
+struct AssetDirs {
+    std::string mesh;
+    std::string texture;
+};
+
+static bool readText(const std::filesystem::path& path, std::string& text) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream.is_open()) return false;
+    std::stringstream ss;
+    ss << stream.rdbuf();
+    text = ss.str();
+    return true;
+}
+
+static bool isXmlSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Value of name="..." (or '...') in an element's attribute text, empty if absent
+static std::string attribute(const std::string& attributes, const char* name) {
+    const size_t length = std::strlen(name);
+    for (size_t at = attributes.find(name); at != std::string::npos; at = attributes.find(name, at + 1)) {
+        // Whole attribute names only: "file" must not match inside "fileleft" or "profile"
+        if (at > 0 && !isXmlSpace(attributes[at - 1])) continue;
+        size_t i = at + length;
+        while (i < attributes.size() && isXmlSpace(attributes[i])) ++i;
+        if (i >= attributes.size() || attributes[i] != '=') continue;
+        ++i;
+        while (i < attributes.size() && isXmlSpace(attributes[i])) ++i;
+        if (i >= attributes.size() || (attributes[i] != '"' && attributes[i] != '\'')) continue;
+
+        size_t end = attributes.find(attributes[i], i + 1);
+        if (end == std::string::npos) return std::string();
+        return attributes.substr(i + 1, end - i - 1);
+    }
+    return std::string();
+}
+
+// Comments can hold whole elements (commented-out includes and meshes); they must not be followed
+static std::string stripXmlComments(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    size_t pos = 0;
+    for (size_t open = text.find("<!--"); open != std::string::npos; open = text.find("<!--", pos)) {
+        result.append(text, pos, open - pos);
+        size_t close = text.find("-->", open + 4);
+        if (close == std::string::npos) return result; // unterminated: the rest is comment
+        pos = close + 3;
+    }
+    result.append(text, pos, std::string::npos);
+    return result;
+}
+
+// Hashes an MJCF file and, recursively, everything it pulls in. Returns false if
+// any dependency can't be found or resolved; the caller then skips the cache.
+static bool hashModelInputs(const std::filesystem::path& xmlPath, const std::filesystem::path& modelDir,
+                            AssetDirs& dirs, std::set<std::string>& visited, uint64_t& hash) {
+    std::string text;
+    if (!readText(xmlPath, text)) return false;
+    if (!visited.insert(xmlPath.lexically_normal().string()).second) return true;
+
+    hash = Hash::fnv1a(xmlPath.filename().string(), hash);
+    hash = Hash::fnv1a(text, hash);
+
+    // The raw text is hashed (comments included); only the elements outside comments are followed
+    std::string markup = stripXmlComments(text);
+    static const std::regex element("<\\s*([A-Za-z_]+)([^>]*)>");
+    for (auto it = std::sregex_iterator(markup.begin(), markup.end(), element); it != std::sregex_iterator(); ++it) {
+        std::string tag = (*it)[1].str();
+        std::string attributes = (*it)[2].str();
+
+        if (tag == "compiler") {
+            std::string assetdir = attribute(attributes, "assetdir");
+            std::string meshdir = attribute(attributes, "meshdir");
+            std::string texturedir = attribute(attributes, "texturedir");
+            if (!assetdir.empty()) dirs.mesh = dirs.texture = assetdir;
+            if (!meshdir.empty()) dirs.mesh = meshdir;
+            if (!texturedir.empty()) dirs.texture = texturedir;
+            continue;
+        }
+
+        // URDF meshes use package:// URIs we can't resolve reliably
+        if (!attribute(attributes, "filename").empty()) return false;
+
+        std::string file = attribute(attributes, "file");
+
+        if (tag == "include" || tag == "model") {
+            if (file.empty()) continue;
+            std::filesystem::path included = modelDir / file;
+            if (!hashModelInputs(included, modelDir, dirs, visited, hash)) return false;
+            continue;
+        }
+
+        // Assets: mesh, skin, hfield -> meshdir; texture (including cube faces) -> texturedir
+        std::vector<std::string> files = { file };
+        if (tag == "texture") {
+            for (const char* face : { "fileright", "fileleft", "fileup", "filedown", "filefront", "fileback" })
+                files.push_back(attribute(attributes, face));
+        }
+
+        const std::string& dir = tag == "texture" ? dirs.texture : dirs.mesh;
+        for (const std::string& name : files) {
+            if (name.empty()) continue;
+            std::filesystem::path asset = std::filesystem::path(name).is_absolute() ? std::filesystem::path(name)
+                                                                                    : modelDir / dir / name;
+            hash = Hash::fnv1a(name, hash);
+            if (!Hash::file(asset.string(), hash)) return false;
+        }
+    }
+    return true;
+}
+
 void MujocoSim::loadModel(const std::string& modelPath) {
     cleanup();
 
-    m_ = mj_loadXML(modelPath.c_str(), nullptr, error_, 1000);
+    // 1. Try the compiled cache
+    std::string cachePath;
+    if (useModelCache_) {
+        std::filesystem::path xmlPath(modelPath);
+        AssetDirs dirs;
+        std::set<std::string> visited;
+
+        // The binary format is version specific, so the version is part of the key
+        int version = mj_version();
+        uint64_t hash = Hash::fnv1a(&version, sizeof(version));
+
+        if (hashModelInputs(xmlPath, xmlPath.parent_path(), dirs, visited, hash)) {
+            cachePath = FileSystem::getCachePath("mujoco/" + xmlPath.stem().string() + "_" + Hash::toHex(hash) + ".mjb");
+            if (std::filesystem::exists(cachePath)) {
+                m_ = mj_loadModel(cachePath.c_str(), nullptr);
+                if (m_) std::cout << "Loaded compiled model from cache: " << cachePath << std::endl;
+            }
+        }
+    }
+
+    // 2. Cache miss: parse and compile the XML
     if (!m_) {
-        throw std::runtime_error("Failed to load MuJoCo model: " + std::string(error_));
+        m_ = mj_loadXML(modelPath.c_str(), nullptr, error_, 1000);
+        if (!m_) {
+            throw std::runtime_error("Failed to load MuJoCo model: " + std::string(error_));
+        }
+
+        // Write to a temporary name and rename, so a crash never leaves a truncated cache entry
+        if (!cachePath.empty()) {
+            std::string tempPath = cachePath + ".tmp";
+            mj_saveModel(m_, tempPath.c_str(), nullptr, 0);
+            std::error_code ec;
+            std::filesystem::rename(tempPath, cachePath, ec);
+            if (ec) std::filesystem::remove(tempPath, ec);
+        }
     }
 
     d_ = mj_makeData(m_);
@@ -24,7 +187,11 @@ void MujocoSim::loadModel(const std::string& modelPath) {
         cleanup();
         throw std::runtime_error("Failed to create MuJoCo data structure.");
     }
-    
+
+    // Compute initial poses so geom_xpos/geom_xmat are valid before the first step
+    mj_forward(m_, d_);
+    resetPoseTracking();
+
     std::cout << "Successfully loaded model: " << modelPath << std::endl;
     std::cout << "Geom count: " << m_->ngeom << std::endl;
 }
@@ -38,6 +205,10 @@ void MujocoSim::cleanup() {
         mj_deleteModel(m_);
         m_ = nullptr;
     }
+    dynamicBodies_.clear();
+    bodyPoseCache_.clear();
+    bodyVersion_.clear();
+    geomVersion_.clear();
 }
 
 void MujocoSim::step() {
@@ -77,4 +248,111 @@ void MujocoSim::getGeomTransform(int index, float* pos, float* mat) const {
     for (int i = 0; i < 9; ++i) {
         mat[i] = static_cast<float>(d_->geom_xmat[index * 9 + i]);
     }
+}
+
+// --- Bulk Pose Export ---
+
+void MujocoSim::resetPoseTracking() {
+    dynamicBodies_.clear();
+    for (int b = 1; b < m_->nbody; ++b) {
+        if (m_->body_weldid[b] != 0 || m_->body_mocapid[b] >= 0)
+            dynamicBodies_.push_back(b);
+    }
+
+    bodyPoseCache_.assign(7 * m_->nbody, 0.0);
+    for (int b = 0; b < m_->nbody; ++b) {
+        std::memcpy(&bodyPoseCache_[7 * b], d_->xpos + 3 * b, 3 * sizeof(mjtNum));
+        std::memcpy(&bodyPoseCache_[7 * b + 3], d_->xquat + 4 * b, 4 * sizeof(mjtNum));
+    }
+    bodyVersion_.assign(m_->nbody, 0);
+    invalidatePoses();
+}
+
+void MujocoSim::invalidatePoses() {
+    // No body version ever matches this, so every geom is rewritten once
+    geomVersion_.assign(m_ ? m_->ngeom : 0, ~0u);
+}
+
+// Writes one geom as a column-major mat4: the row-major 3x3 xmat plus xpos, transposed.
+// Rows are packed as (r0 r1 r2 px), (r3 r4 r5 py), (r6 r7 r8 pz), (0 0 0 1); a 4x4
+// transpose then yields the four GL columns directly.
+static inline void writeGeomMatrix(const mjtNum* p, const mjtNum* r, float* dst) {
+#if defined(TOON_POSE_SSE2)
+    __m128 row0 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(r + 0)), _mm_cvtpd_ps(_mm_set_pd(p[0], r[2])));
+    __m128 row1 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(r + 3)), _mm_cvtpd_ps(_mm_set_pd(p[1], r[5])));
+    __m128 row2 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(r + 6)), _mm_cvtpd_ps(_mm_set_pd(p[2], r[8])));
+    __m128 row3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+    _mm_storeu_ps(dst + 0, row0);
+    _mm_storeu_ps(dst + 4, row1);
+    _mm_storeu_ps(dst + 8, row2);
+    _mm_storeu_ps(dst + 12, row3);
+#elif defined(TOON_POSE_NEON)
+    const float64x2_t tail0 = { r[2], p[0] };
+    const float64x2_t tail1 = { r[5], p[1] };
+    const float64x2_t tail2 = { r[8], p[2] };
+    float32x4_t row0 = vcombine_f32(vcvt_f32_f64(vld1q_f64(r + 0)), vcvt_f32_f64(tail0));
+    float32x4_t row1 = vcombine_f32(vcvt_f32_f64(vld1q_f64(r + 3)), vcvt_f32_f64(tail1));
+    float32x4_t row2 = vcombine_f32(vcvt_f32_f64(vld1q_f64(r + 6)), vcvt_f32_f64(tail2));
+    const float row3Data[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    float32x4_t row3 = vld1q_f32(row3Data);
+
+    float32x4x2_t a = vzipq_f32(row0, row2);
+    float32x4x2_t b = vzipq_f32(row1, row3);
+    float32x4x2_t lo = vzipq_f32(a.val[0], b.val[0]);
+    float32x4x2_t hi = vzipq_f32(a.val[1], b.val[1]);
+    vst1q_f32(dst + 0, lo.val[0]);
+    vst1q_f32(dst + 4, lo.val[1]);
+    vst1q_f32(dst + 8, hi.val[0]);
+    vst1q_f32(dst + 12, hi.val[1]);
+#else
+    for (int c = 0; c < 3; ++c) {
+        dst[4 * c + 0] = static_cast<float>(r[c]);
+        dst[4 * c + 1] = static_cast<float>(r[3 + c]);
+        dst[4 * c + 2] = static_cast<float>(r[6 + c]);
+        dst[4 * c + 3] = 0.0f;
+    }
+    dst[12] = static_cast<float>(p[0]);
+    dst[13] = static_cast<float>(p[1]);
+    dst[14] = static_cast<float>(p[2]);
+    dst[15] = 1.0f;
+#endif
+}
+
+int MujocoSim::exportGeomPoses(float* out, int first, int count, std::vector<int>* changed) {
+    if (!m_ || !d_ || !out) return 0;
+    if (first < 0) first = 0;
+    if (count < 0 || first + count > m_->ngeom) count = m_->ngeom - first;
+    if (count <= 0) return 0;
+
+    // 1. Detect moved bodies (nbody is much smaller than ngeom; static bodies are never visited)
+    for (int b : dynamicBodies_) {
+        mjtNum* cached = &bodyPoseCache_[7 * b];
+        const mjtNum* xpos = d_->xpos + 3 * b;
+        const mjtNum* xquat = d_->xquat + 4 * b;
+
+        bool moved = false;
+        for (int i = 0; i < 3 && !moved; ++i) moved = std::fabs(xpos[i] - cached[i]) > poseEpsilon_;
+        for (int i = 0; i < 4 && !moved; ++i) moved = std::fabs(xquat[i] - cached[3 + i]) > poseEpsilon_;
+
+        if (moved) {
+            std::memcpy(cached, xpos, 3 * sizeof(mjtNum));
+            std::memcpy(cached + 3, xquat, 4 * sizeof(mjtNum));
+            ++bodyVersion_[b];
+        }
+    }
+
+    // 2. Rewrite geoms whose body version differs from the one they were exported at
+    int written = 0;
+    for (int i = 0; i < count; ++i) {
+        int g = first + i;
+        unsigned int version = bodyVersion_[m_->geom_bodyid[g]];
+        if (geomVersion_[g] == version) continue;
+
+        writeGeomMatrix(d_->geom_xpos + 3 * g, d_->geom_xmat + 9 * g, out + 16 * i);
+        geomVersion_[g] = version;
+        if (changed) changed->push_back(g);
+        ++written;
+    }
+    return written;
 }
\ No newline at end of file
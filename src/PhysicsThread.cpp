@@ -0,0 +1,147 @@
+#include "PhysicsThread.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+PhysicsThread::PhysicsThread(MujocoSim& sim) : sim_(sim) {
+}
+
+PhysicsThread::~PhysicsThread() {
+    stop();
+}
+
+double PhysicsThread::now() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void PhysicsThread::start() {
+    if (running_.load() || !sim_.getModel()) return;
+
+    poses_.assign(sim_.getGeomCount(), glm::mat4(1.0f));
+    changedMark_.assign(sim_.getGeomCount(), 0);
+    carried_.clear();
+    sim_.invalidatePoses();
+
+    // Publish the initial state synchronously so the renderer has something to show
+    publish(now());
+
+    running_.store(true);
+    thread_ = std::thread(&PhysicsThread::run, this);
+}
+
+void PhysicsThread::stop() {
+    running_.store(false);
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void PhysicsThread::publish(double wallTime) {
+    changed_.clear();
+    sim_.exportGeomPoses(&poses_[0][0][0], 0, -1, &changed_);
+
+    // Merge in what moved in snapshots the render thread never took
+    if (!carried_.empty()) {
+        for (int g : changed_) changedMark_[g] = 1;
+        for (int g : carried_)
+            if (!changedMark_[g]) changed_.push_back(g);
+        for (int g : changed_) changedMark_[g] = 0;
+    }
+
+    PoseSnapshot& slot = buffer_.writeBuffer();
+    slot.geomModels = poses_; // reuses the slot's capacity after the first few publishes
+    slot.changed = changed_;
+    slot.simTime = sim_.getData()->time;
+    slot.wallTime = wallTime;
+    slot.sequence = ++sequence_;
+
+    // Replaced unread: its list (already merged) comes back with the slot and goes into the next publish
+    if (buffer_.publish()) std::swap(carried_, buffer_.writeBuffer().changed);
+    else carried_.clear();
+}
+
+void PhysicsThread::run() {
+    Profiler::setThreadName("Physics");
+    const double dt = sim_.getModel()->opt.timestep;
+
+    double last = now();
+    double accumulator = 0.0;
+    double lastPublish = -std::numeric_limits<double>::infinity();
+    bool pendingPublish = false;
+
+    double windowStart = last;
+    double windowSimStart = sim_.getData()->time;
+    long windowSteps = 0;
+
+    while (running_.load()) {
+        double t = now();
+        double rtf = targetRTF_.load();
+        accumulator += (t - last) * rtf;
+        last = t;
+
+        // 1. Fixed steps, bounded by the catch-up budget
+        int budget = maxCatchUpSteps_.load();
+        int steps = 0;
+        if (accumulator >= dt) {
+            PROFILE_SCOPE("Physics Step");
+            while (accumulator >= dt && steps < budget) {
+                sim_.step();
+                accumulator -= dt;
+                ++steps;
+            }
+        }
+
+        // Still behind: drop the backlog instead of carrying it into the next tick
+        if (accumulator >= dt) {
+            droppedTime_.store(droppedTime_.load() + accumulator / rtf);
+            accumulator = 0.0;
+        }
+
+        windowSteps += steps;
+        pendingPublish = pendingPublish || steps > 0;
+
+        // 2. Hand poses to the render thread (rate limited, never blocks)
+        if (pendingPublish && t - lastPublish >= publishInterval_.load()) {
+            PROFILE_SCOPE("Publish Poses");
+            publish(t);
+            lastPublish = t;
+            pendingPublish = false;
+        }
+
+        // 3. Statistics
+        if (t - windowStart >= 0.5) {
+            double simNow = sim_.getData()->time;
+            achievedRTF_.store((simNow - windowSimStart) / (t - windowStart));
+            stepsPerSecond_.store(windowSteps / (t - windowStart));
+            windowStart = t;
+            windowSimStart = simNow;
+            windowSteps = 0;
+        }
+
+        // 4. Sleep until the next step is due (capped so RTF changes and stop() apply quickly)
+        double wait = rtf > 0.0 ? (dt - accumulator) / rtf : 0.01;
+        if (pendingPublish)
+            wait = std::min(wait, publishInterval_.load() - (t - lastPublish));
+        wait = std::min(wait, 0.01);
+        if (wait > 0.0)
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    }
+}
+
+bool PhysicsThread::poll() {
+    if (!buffer_.fetch()) return false;
+
+    // O(1) hand-over: the stale vectors go back into the slot and are overwritten by the producer
+    std::swap(previous_, current_);
+    std::swap(current_, buffer_.readBuffer());
+    return true;
+}
+
+float PhysicsThread::getInterpolationAlpha(double wallNow) const {
+    double interval = current_.wallTime - previous_.wallTime;
+    if (interval <= 0.0 || previous_.geomModels.empty()) return 1.0f;
+    double alpha = (wallNow - current_.wallTime) / interval;
+    return static_cast<float>(std::clamp(alpha, 0.0, 1.0));
+}
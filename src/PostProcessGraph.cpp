@@ -0,0 +1,189 @@
+#include "PostProcessGraph.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream stream(path);
+    if (!stream.is_open()) {
+        std::cout << "ERROR::POSTPROCESS::FILE_NOT_FOUND: " << path << std::endl;
+        return std::string();
+    }
+    std::stringstream ss;
+    ss << stream.rdbuf();
+    return ss.str();
+}
+
+} // namespace
+
+PostProcessGraph::PostProcessGraph(const std::string& directory, RenderTargetPool& targets)
+    : directory(directory), targets(targets) {
+    vertexSource = readFile(directory + "/fullscreen.glsl");
+    commonSource = readFile(directory + "/common.glsl");
+
+    // The full-screen triangle is generated from gl_VertexID, but core profile still wants a VAO bound
+    glGenVertexArrays(1, &emptyVAO);
+
+    // Color inputs are read filtered and clamped whatever their own texture parameters say
+    glGenSamplers(1, &linearSampler);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(linearSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+PostProcessGraph::~PostProcessGraph() {
+    for (auto& entry : programs) glDeleteProgram(entry.second->ID);
+    glDeleteSamplers(1, &linearSampler);
+    glDeleteVertexArrays(1, &emptyVAO);
+}
+
+PostPass& PostProcessGraph::AddPass(const std::string& name, bool pointwise, std::vector<PostParam> params, bool enabled) {
+    for (PostParam& param : params) param.id = Shader::uniformId(param.name);
+
+    PostPass pass;
+    pass.name = name;
+    pass.pointwise = pointwise;
+    pass.enabled = enabled;
+    pass.params = std::move(params);
+    passes.push_back(std::move(pass));
+    return passes.back();
+}
+
+PostPass* PostProcessGraph::GetPass(const std::string& name) {
+    for (PostPass& pass : passes)
+        if (pass.name == name) return &pass;
+    return nullptr;
+}
+
+void PostProcessGraph::BuildGroups() {
+    groups.clear();
+    for (const PostPass& pass : passes) {
+        if (!pass.enabled) continue;
+        if (groups.empty() || !pass.pointwise) groups.emplace_back();
+        groups.back().passes.push_back(&pass);
+    }
+    // Nothing enabled: still one draw, copying the scene to the target
+    if (groups.empty()) groups.emplace_back();
+
+    for (Group& group : groups) group.program = GetProgram(group.passes);
+}
+
+const std::string& PostProcessGraph::GetSnippet(const std::string& name) {
+    auto it = snippets.find(name);
+    if (it == snippets.end()) it = snippets.emplace(name, readFile(directory + "/" + name + ".glsl")).first;
+    return it->second;
+}
+
+Shader* PostProcessGraph::GetProgram(const std::vector<const PostPass*>& fused) {
+    std::string key;
+    for (const PostPass* pass : fused) key += pass->name + "+";
+
+    auto it = programs.find(key);
+    if (it != programs.end()) return it->second.get();
+
+    // #version, the shared inputs, each snippet once, then main() calling them in order
+    std::ostringstream fragment;
+    fragment << "#version 410 core\nout vec4 FragColor;\nin vec2 TexCoords;\n\n" << commonSource << "\n";
+    for (const PostPass* pass : fused) fragment << GetSnippet(pass->name) << "\n";
+
+    fragment << "void main() {\n    vec2 uv = TexCoords;\n";
+    size_t first = 0;
+    if (!fused.empty() && !fused[0]->pointwise) {
+        fragment << "    vec3 color = " << fused[0]->name << "(uv);\n";
+        first = 1;
+    } else {
+        fragment << "    vec3 color = SampleColor(uv);\n";
+    }
+    for (size_t i = first; i < fused.size(); ++i)
+        fragment << "    color = " << fused[i]->name << "(color, uv);\n";
+    fragment << "    FragColor = vec4(color, 1.0);\n}\n";
+
+    auto program = std::make_unique<Shader>(vertexSource, fragment.str(), "post[" + key + "]");
+    Shader* result = program.get();
+    programs.emplace(key, std::move(program));
+    return result;
+}
+
+void PostProcessGraph::Execute(const PostInputs& inputs, unsigned int target, int targetWidth, int targetHeight) {
+    static const Uniform<int> uScreenTexture("screenTexture");
+    static const Uniform<int> uDepthTexture("depthTexture");
+    static const Uniform<glm::vec2> uColorScale("colorScale");
+    static const Uniform<glm::vec2> uColorMax("colorMax");
+    static const Uniform<glm::vec2> uDepthScale("depthScale");
+    static const Uniform<glm::vec2> uDepthMax("depthMax");
+    static const Uniform<glm::vec2> uOutputTexelSize("outputTexelSize");
+    static const Uniform<glm::vec2> uCameraPlanes("cameraPlanes");
+
+    BuildGroups();
+
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(emptyVAO);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, inputs.depth);
+    glBindSampler(0, linearSampler);
+
+    // Output uv (0 - 1) to the scene's viewport in its textures. Reads are clamped half a
+    // texel inside it: past that, filtering would pull in whatever the full-size targets
+    // held outside the viewport
+    glm::vec2 size(inputs.width, inputs.height);
+    glm::vec2 viewport(inputs.viewportWidth > 0 ? inputs.viewportWidth : inputs.width,
+                       inputs.viewportHeight > 0 ? inputs.viewportHeight : inputs.height);
+    glm::vec2 sceneScale = viewport / size;
+    glm::vec2 sceneMax = (viewport - 0.5f) / size;
+    glm::vec2 outputTexelSize(1.0f / targetWidth, 1.0f / targetHeight);
+    glm::vec2 cameraPlanes(inputs.nearPlane, inputs.farPlane);
+
+    unsigned int source = inputs.color;
+    RenderTarget* previous = nullptr;
+
+    drawCount = 0;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const Group& group = groups[i];
+        bool last = i + 1 == groups.size();
+
+        // Intermediates match the target, so only the first group resamples the scene
+        RenderTarget* output = nullptr;
+        if (last) {
+            glBindFramebuffer(GL_FRAMEBUFFER, target);
+        } else {
+            output = targets.Acquire(targetWidth, targetHeight, GL_RGBA8);
+            glBindFramebuffer(GL_FRAMEBUFFER, targets.GetFramebuffer(output, nullptr));
+        }
+        glViewport(0, 0, targetWidth, targetHeight);
+
+        Shader& program = *group.program;
+        program.use();
+        program.set(uScreenTexture, 0);
+        program.set(uDepthTexture, 1);
+        if (i == 0) {
+            program.set(uColorScale, sceneScale);
+            program.set(uColorMax, sceneMax);
+        } else {
+            program.set(uColorScale, glm::vec2(1.0f));
+            program.set(uColorMax, glm::vec2(1.0f) - 0.5f * outputTexelSize);
+        }
+        program.set(uDepthScale, sceneScale);
+        program.set(uDepthMax, sceneMax);
+        program.set(uOutputTexelSize, outputTexelSize);
+        program.set(uCameraPlanes, cameraPlanes);
+        for (const PostPass* pass : group.passes)
+            for (const PostParam& param : pass->params) glUniform1f(program.location(param.id), param.value);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, source);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        ++drawCount;
+
+        // Read by this draw and nothing after it: the next group may render into it
+        targets.Release(previous);
+        previous = output;
+        if (output) source = output->texture;
+    }
+
+    glBindSampler(0, 0);
+}
@@ -0,0 +1,334 @@
+#include "Profiler.h"
+#include "Hash.h"
+
+#include <glad/glad.h>
+#include <imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+std::atomic<bool> Profiler::enabled_{true};
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+int64_t Profiler::now() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::ThreadRing& Profiler::localRing() {
+    // Registered on the thread's first scope and retired when it exits; beginFrame frees a
+    // retired ring once drained, and the next new thread takes it over
+    struct Owner {
+        ThreadRing* ring = nullptr;
+        ~Owner() {
+            if (ring) ring->retired.store(true, std::memory_order_release);
+        }
+    };
+    thread_local Owner owner;
+    if (!owner.ring) {
+        Profiler& profiler = instance();
+        std::lock_guard<std::mutex> lock(profiler.ringMutex_);
+        for (const auto& ring : profiler.rings_) {
+            if (ring->free) {
+                owner.ring = ring.get();
+                break;
+            }
+        }
+        if (!owner.ring) {
+            profiler.rings_.push_back(std::make_unique<ThreadRing>());
+            owner.ring = profiler.rings_.back().get();
+            owner.ring->index = static_cast<uint32_t>(profiler.rings_.size() - 1);
+        }
+        owner.ring->free = false;
+        owner.ring->retired.store(false, std::memory_order_relaxed);
+        owner.ring->depth = 0;
+        owner.ring->name = "Thread " + std::to_string(owner.ring->index);
+    }
+    return *owner.ring;
+}
+
+void Profiler::setThreadName(const char* name) {
+    ThreadRing& ring = localRing();
+    std::lock_guard<std::mutex> lock(instance().ringMutex_);
+    ring.name = name;
+}
+
+uint32_t Profiler::beginScope() {
+    return localRing().depth++;
+}
+
+void Profiler::endScope(const char* name, int64_t start, uint32_t depth) {
+    ThreadRing& ring = localRing();
+    ring.depth = depth;
+
+    // Single producer: only this thread moves head, only beginFrame moves tail
+    size_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= kRingCapacity) {
+        instance().dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring.events[head % kRingCapacity] = { name, start, now(), ring.index, depth };
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::addEvent(const ProfileEvent& event) {
+    history_.push_back(event);
+    if (history_.size() > kHistoryEvents) history_.pop_front();
+}
+
+void Profiler::beginFrame() {
+    int64_t frameEnd = now();
+
+    // 1. CPU events from every thread
+    std::vector<ThreadRing*> rings, retired;
+    {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        for (const auto& ring : rings_)
+            if (!ring->free) rings.push_back(ring.get());
+    }
+
+    std::lock_guard<std::mutex> lock(historyMutex_);
+    lastFrame_.clear();
+    for (ThreadRing* ring : rings) {
+        // Checked before draining: a thread seen as exited has published its last event
+        if (ring->retired.load(std::memory_order_acquire)) retired.push_back(ring);
+        size_t tail = ring->tail.load(std::memory_order_relaxed);
+        size_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            const ProfileEvent& event = ring->events[tail % kRingCapacity];
+            addEvent(event);
+            if (event.end >= frameStart_ && event.start < frameEnd) lastFrame_.push_back(event);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+    if (!retired.empty()) {
+        std::lock_guard<std::mutex> ringLock(ringMutex_);
+        for (ThreadRing* ring : retired) ring->free = true;
+    }
+    lastFrameStart_ = frameStart_;
+    lastFrameEnd_ = frameEnd;
+    frameStart_ = frameEnd;
+
+    // 2. GPU queries issued kGpuLatency frames ago, then reuse their slot for this frame
+    if (!gpuAvailable_) return;
+    GpuFrame& frame = gpuFrames_[frameIndex_++ % kGpuLatency];
+    collectGpu(frame);
+
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    frame.cpuMinusGpu = now() - gpuNow;
+    frame.cpuStart = frameEnd;
+}
+
+void Profiler::collectGpu(GpuFrame& frame) {
+    if (frame.queries.empty()) return;
+
+    // Never wait: a frame whose last query isn't done yet is dropped. Timestamps complete in
+    // issue order, and with nesting the last one issued is an outer scope's end, not queries.back()
+    GLuint available = 0;
+    if (frame.used > 0) glGetQueryObjectuiv(frame.pool[frame.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+        lastGpuFrame_.clear();
+        int64_t first = INT64_MAX, last = 0;
+        for (const GpuQuery& query : frame.queries) {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+
+            ProfileEvent event = { query.name, static_cast<int64_t>(begin) + frame.cpuMinusGpu,
+                                   static_cast<int64_t>(end) + frame.cpuMinusGpu, kGpuThread, query.depth };
+            addEvent(event);
+            lastGpuFrame_.push_back(event);
+            first = std::min(first, event.start);
+            last = std::max(last, event.end);
+        }
+        lastGpuFrameStart_ = frame.cpuStart;
+        lastGpuFrameMs_ = (last - first) * 1e-6;
+    } else {
+        dropped_.fetch_add(frame.queries.size(), std::memory_order_relaxed);
+    }
+    frame.queries.clear();
+    frame.used = 0;
+}
+
+unsigned int Profiler::acquireQuery(GpuFrame& frame) {
+    if (frame.used == frame.pool.size()) {
+        // Grow in blocks; the pool settles after the first few frames
+        size_t grow = std::max<size_t>(16, frame.pool.size());
+        frame.pool.resize(frame.pool.size() + grow);
+        glGenQueries(static_cast<GLsizei>(grow), &frame.pool[frame.used]);
+    }
+    return frame.pool[frame.used++];
+}
+
+void Profiler::beginGpuScope(const char* name) {
+    if (!gpuAvailable_ || frameIndex_ == 0) return;
+    GpuFrame& frame = gpuFrames_[(frameIndex_ - 1) % kGpuLatency];
+
+    GpuQuery query;
+    query.name = name;
+    query.begin = acquireQuery(frame);
+    query.end = 0;
+    query.depth = static_cast<uint32_t>(gpuStack_.size());
+    glQueryCounter(query.begin, GL_TIMESTAMP);
+
+    gpuStack_.push_back(frame.queries.size());
+    frame.queries.push_back(query);
+}
+
+void Profiler::endGpuScope() {
+    if (!gpuAvailable_ || frameIndex_ == 0 || gpuStack_.empty()) return;
+    GpuFrame& frame = gpuFrames_[(frameIndex_ - 1) % kGpuLatency];
+
+    GpuQuery& query = frame.queries[gpuStack_.back()];
+    gpuStack_.pop_back();
+    query.end = acquireQuery(frame);
+    glQueryCounter(query.end, GL_TIMESTAMP);
+}
+
+void Profiler::shutdownGpu() {
+    for (GpuFrame& frame : gpuFrames_) {
+        if (!frame.pool.empty()) glDeleteQueries(static_cast<GLsizei>(frame.pool.size()), frame.pool.data());
+        frame = GpuFrame();
+    }
+    gpuStack_.clear();
+    gpuAvailable_ = false;
+}
+
+std::string Profiler::threadName(uint32_t thread) const {
+    if (thread == kGpuThread) return "GPU";
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    return thread < rings_.size() ? rings_[thread]->name : "Thread " + std::to_string(thread);
+}
+
+static void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::vector<ProfileEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(historyMutex_);
+        events.assign(history_.begin(), history_.end());
+    }
+    if (events.empty()) return static_cast<bool>(out << "{\"traceEvents\":[]}\n");
+
+    int64_t origin = events.front().start;
+    for (const ProfileEvent& event : events) origin = std::min(origin, event.start);
+
+    // Complete ("X") events in microseconds; tids are thread indices, the GPU gets its own row
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    std::vector<uint32_t> threads;
+    char buffer[128];
+    for (size_t i = 0; i < events.size(); ++i) {
+        const ProfileEvent& event = events[i];
+        uint32_t tid = event.thread == kGpuThread ? 1000000u : event.thread;
+        if (std::find(threads.begin(), threads.end(), event.thread) == threads.end()) threads.push_back(event.thread);
+
+        out << "{\"name\":";
+        writeJsonString(out, event.name);
+        std::snprintf(buffer, sizeof(buffer), ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n",
+                      event.thread == kGpuThread ? "gpu" : "cpu", tid, (event.start - origin) * 1e-3,
+                      (event.end - event.start) * 1e-3);
+        out << buffer;
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        uint32_t tid = threads[i] == kGpuThread ? 1000000u : threads[i];
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+        writeJsonString(out, threadName(threads[i]));
+        out << "}}" << (i + 1 < threads.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+    return static_cast<bool>(out);
+}
+
+void Profiler::drawWindow(bool* open) {
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+    bool enabled = isEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled)) setEnabled(enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Save Trace")) {
+        const char* path = "toon_trace.json";
+        if (writeChromeTrace(path)) std::cout << "Wrote trace " << path << " (open in chrome://tracing)" << std::endl;
+        else std::cout << "ERROR::PROFILER::WRITE_FAILED " << path << std::endl;
+    }
+    ImGui::Text("CPU frame %.2f ms, GPU %.2f ms, %llu events dropped", getLastFrameMs(), getLastGpuFrameMs(),
+                (unsigned long long)getDroppedEvents());
+
+    std::vector<ProfileEvent> cpuEvents, gpuEvents;
+    {
+        std::lock_guard<std::mutex> lock(historyMutex_);
+        cpuEvents = lastFrame_;
+        gpuEvents = lastGpuFrame_;
+    }
+
+    // One band per thread (GPU last), one row per nesting level; x spans the last CPU frame
+    std::vector<uint32_t> threads;
+    for (const ProfileEvent& event : cpuEvents)
+        if (std::find(threads.begin(), threads.end(), event.thread) == threads.end()) threads.push_back(event.thread);
+    std::sort(threads.begin(), threads.end());
+    if (!gpuEvents.empty()) threads.push_back(kGpuThread);
+
+    const float rowHeight = 18.0f, labelWidth = 90.0f;
+    double frameNs = std::max<double>(1.0, double(lastFrameEnd_ - lastFrameStart_));
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(100.0f, ImGui::GetContentRegionAvail().x - labelWidth);
+    float y = origin.y;
+
+    for (uint32_t thread : threads) {
+        const std::vector<ProfileEvent>& events = thread == kGpuThread ? gpuEvents : cpuEvents;
+        int64_t start = thread == kGpuThread ? lastGpuFrameStart_ : lastFrameStart_;
+
+        uint32_t maxDepth = 0;
+        drawList->AddText(ImVec2(origin.x, y + 2.0f), IM_COL32(220, 220, 220, 255), threadName(thread).c_str());
+        for (const ProfileEvent& event : events) {
+            if (event.thread != thread) continue;
+            maxDepth = std::max(maxDepth, event.depth);
+
+            float x0 = origin.x + labelWidth + float((event.start - start) / frameNs) * width;
+            float x1 = origin.x + labelWidth + float((event.end - start) / frameNs) * width;
+            x0 = std::max(x0, origin.x + labelWidth);
+            x1 = std::min(std::max(x1, x0 + 1.0f), origin.x + labelWidth + width);
+            if (x1 <= x0) continue;
+
+            ImVec2 min(x0, y + event.depth * rowHeight), max(x1, y + (event.depth + 1) * rowHeight - 1.0f);
+            // Stable color per name
+            uint64_t hash = Hash::fnv1a(event.name, std::strlen(event.name));
+            ImU32 color = IM_COL32(80 + hash % 120, 80 + (hash >> 8) % 120, 80 + (hash >> 16) % 120, 255);
+            drawList->AddRectFilled(min, max, color);
+            if (x1 - x0 > 30.0f) {
+                drawList->PushClipRect(min, max, true);
+                drawList->AddText(ImVec2(x0 + 2.0f, min.y + 2.0f), IM_COL32(255, 255, 255, 255), event.name);
+                drawList->PopClipRect();
+            }
+            if (ImGui::IsMouseHoveringRect(min, max))
+                ImGui::SetTooltip("%s: %.3f ms", event.name, (event.end - event.start) * 1e-6);
+        }
+        y += (maxDepth + 1) * rowHeight + 4.0f;
+    }
+    ImGui::Dummy(ImVec2(labelWidth + width, y - origin.y));
+    ImGui::End();
+}
@@ -0,0 +1,135 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+// Field widths of the sort key (see RenderQueue.h)
+static const int kDepthBits = 20;
+static const int kVAOBits = 16;
+static const int kMaterialBits = 16;
+static const int kProgramBits = 10;
+static const uint64_t kDepthMax = (1ull << kDepthBits) - 1;
+
+static uint64_t field(uint64_t value, int bits) {
+    return value & ((1ull << bits) - 1);
+}
+
+static size_t indexSize(GLenum type) {
+    return type == GL_UNSIGNED_SHORT ? 2 : type == GL_UNSIGNED_BYTE ? 1 : 4;
+}
+
+// Same textures on the same units read through the same sampler names
+static bool sameMaterial(const RenderMaterial* a, const RenderMaterial* b) {
+    if (a == b) return true;
+    return a && b && a->SameAs(*b);
+}
+
+RenderQueue::RenderQueue()
+    : view(1.0f), farPlane(100.0f), lastPackets(0), programSwitches(0), materialSwitches(0), vaoSwitches(0), triangles(0) {
+}
+
+void RenderQueue::Begin(const glm::mat4& view, float farPlane) {
+    this->view = view;
+    this->farPlane = farPlane;
+    packets.clear();
+    objects.clear();
+}
+
+void RenderQueue::Add(DrawPacket packet, const ObjectUniforms& object, RenderPass pass) {
+    if (!packet.shader || packet.VAO == 0 || (packet.count == 0 && packet.drawCount == 0)) return;
+
+    packet.key = makeKey(packet, object.model, pass);
+    packet.object = static_cast<int>(objects.size());
+    objects.push_back(object);
+    packets.push_back(packet);
+}
+
+uint64_t RenderQueue::makeKey(const DrawPacket& packet, const glm::mat4& model, RenderPass pass) const {
+    // Distance of the object origin along the view axis, quantized over [0, farPlane]
+    glm::vec4 viewPosition = view * model[3];
+    float depth = std::min(std::max(-viewPosition.z / farPlane, 0.0f), 1.0f);
+    uint64_t depthKey = static_cast<uint64_t>(depth * kDepthMax);
+    if (pass == PASS_TRANSPARENT) depthKey = kDepthMax - depthKey;
+
+    // Materials group by their first texture; textures are shared through the TextureCache
+    uint64_t material = 0;
+    if (packet.material && !packet.material->textures.empty())
+        material = packet.material->textures[0];
+
+    uint64_t key = field(pass, 2);
+    key = (key << kProgramBits) | field(packet.shader->ID, kProgramBits);
+    key = (key << kMaterialBits) | field(material, kMaterialBits);
+    key = (key << kVAOBits) | field(packet.VAO, kVAOBits);
+    key = (key << kDepthBits) | depthKey;
+    return key;
+}
+
+void RenderQueue::Flush(UniformBuffers& uniforms) {
+    lastPackets = static_cast<int>(packets.size());
+    programSwitches = materialSwitches = vaoSwitches = 0;
+    triangles = 0;
+    if (packets.empty()) return;
+
+    std::sort(packets.begin(), packets.end(),
+              [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; });
+
+    // Every ObjectData block goes up in one write; draws only rebind the range
+    int firstObject = uniforms.WriteObjects(objects.data(), static_cast<int>(objects.size()));
+
+    Shader* shader = nullptr;
+    const RenderMaterial* material = nullptr;
+    unsigned int vao = 0;
+
+    for (const DrawPacket& packet : packets) {
+        bool programChanged = packet.shader != shader;
+        if (programChanged) {
+            packet.shader->use();
+            shader = packet.shader;
+            ++programSwitches;
+        }
+
+        bool materialChanged = !sameMaterial(packet.material, material);
+        if (materialChanged && packet.material) {
+            for (size_t i = 0; i < packet.material->textures.size(); ++i) {
+                glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(i));
+                glBindTexture(packet.material->TargetOf(i), packet.material->textures[i]);
+            }
+            ++materialSwitches;
+        }
+        // Sampler units are program state: set them for a new program too
+        if ((materialChanged || programChanged) && packet.material) {
+            for (size_t i = 0; i < packet.material->samplers.size(); ++i)
+                shader->set(packet.material->samplers[i], static_cast<int>(i));
+        }
+        material = packet.material;
+
+        if (packet.VAO != vao) {
+            glBindVertexArray(packet.VAO);
+            vao = packet.VAO;
+            ++vaoSwitches;
+        }
+
+        uniforms.BindObject(firstObject + packet.object);
+
+        if (packet.drawCount > 0) {
+            for (GLsizei i = 0; i < packet.drawCount; ++i) triangles += packet.counts[i] / 3;
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, packet.counts, packet.indexType, packet.indexOffsets,
+                                          packet.drawCount, packet.baseVertices);
+        } else if (packet.indexType == 0) {
+            triangles += (long long)(packet.count / 3) * packet.instanceCount;
+            if (packet.instanceCount > 1) glDrawArraysInstanced(GL_TRIANGLES, packet.firstIndex, packet.count, packet.instanceCount);
+            else glDrawArrays(GL_TRIANGLES, packet.firstIndex, packet.count);
+        } else {
+            triangles += (long long)(packet.count / 3) * packet.instanceCount;
+            const void* offset = (const void*)(size_t(packet.firstIndex) * indexSize(packet.indexType));
+            if (packet.instanceCount > 1)
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, packet.count, packet.indexType, offset, packet.instanceCount, packet.baseVertex);
+            else
+                glDrawElementsBaseVertex(GL_TRIANGLES, packet.count, packet.indexType, offset, packet.baseVertex);
+        }
+    }
+
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+
+    packets.clear();
+    objects.clear();
+}
@@ -0,0 +1,126 @@
+#include "RenderTargetPool.h"
+
+#include <iostream>
+
+namespace {
+
+bool isDepthFormat(GLenum internalFormat) {
+    return internalFormat == GL_DEPTH_COMPONENT || internalFormat == GL_DEPTH_COMPONENT16 ||
+           internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32F;
+}
+
+size_t bytesPerPixel(GLenum internalFormat) {
+    switch (internalFormat) {
+    case GL_R8: return 1;
+    case GL_RG8: case GL_DEPTH_COMPONENT16: case GL_R16F: return 2;
+    case GL_RGB8: return 3;
+    case GL_RGBA16F: return 8;
+    case GL_RGBA32F: return 16;
+    default: return 4;
+    }
+}
+
+} // namespace
+
+RenderTargetPool::~RenderTargetPool() {
+    for (auto& entry : framebuffers) glDeleteFramebuffers(1, &entry.second);
+    for (auto& target : targets) glDeleteTextures(1, &target->texture);
+}
+
+void RenderTargetPool::BeginFrame() {
+    ++frame;
+
+    for (size_t i = 0; i < targets.size();) {
+        RenderTarget& target = *targets[i];
+        target.inUse = false;
+        if (frame - target.lastUsedFrame > kMaxIdleFrames) {
+            Destroy(target);
+            targets[i] = std::move(targets.back());
+            targets.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+RenderTarget* RenderTargetPool::Acquire(int width, int height, GLenum internalFormat) {
+    for (auto& target : targets) {
+        if (!target->inUse && target->width == width && target->height == height && target->internalFormat == internalFormat) {
+            target->inUse = true;
+            target->lastUsedFrame = frame;
+            return target.get();
+        }
+    }
+
+    auto target = std::make_unique<RenderTarget>();
+    target->width = width;
+    target->height = height;
+    target->internalFormat = internalFormat;
+    target->bytes = static_cast<size_t>(width) * height * bytesPerPixel(internalFormat);
+    target->inUse = true;
+    target->lastUsedFrame = frame;
+
+    glGenTextures(1, &target->texture);
+    glBindTexture(GL_TEXTURE_2D, target->texture);
+    if (isDepthFormat(internalFormat)) {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        // Far plane outside the image, so edge filters see no edges at the border
+        float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    totalBytes += target->bytes;
+    ++allocations;
+    targets.push_back(std::move(target));
+    return targets.back().get();
+}
+
+void RenderTargetPool::Release(RenderTarget* target) {
+    if (target) target->inUse = false;
+}
+
+unsigned int RenderTargetPool::GetFramebuffer(const RenderTarget* color, const RenderTarget* depth) {
+    uint64_t key = (static_cast<uint64_t>(color ? color->texture : 0) << 32) | (depth ? depth->texture : 0);
+    auto it = framebuffers.find(key);
+    if (it != framebuffers.end()) return it->second;
+
+    unsigned int fbo = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    if (color) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color->texture, 0);
+    if (depth) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth->texture, 0);
+    if (!color) {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::RENDERTARGETPOOL::FRAMEBUFFER_INCOMPLETE" << std::endl;
+
+    framebuffers.emplace(key, fbo);
+    return fbo;
+}
+
+void RenderTargetPool::Destroy(RenderTarget& target) {
+    // Framebuffers that attach it go with it
+    for (auto it = framebuffers.begin(); it != framebuffers.end();) {
+        if ((it->first >> 32) == target.texture || (it->first & 0xFFFFFFFFu) == target.texture) {
+            glDeleteFramebuffers(1, &it->second);
+            it = framebuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    glDeleteTextures(1, &target.texture);
+    totalBytes -= target.bytes;
+}
@@ -0,0 +1,126 @@
+#include "ResidencyManager.h"
+#include "TextureCache.h"
+
+#include <iostream>
+#include <vector>
+
+ResidencyManager& ResidencyManager::instance() {
+    static ResidencyManager manager;
+    return manager;
+}
+
+ResidencyId ResidencyManager::track(const std::string& name, std::function<void()> evict, std::function<void()> restore) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry;
+    entry.id = nextId_++;
+    entry.name = name;
+    entry.lastUsed = frame_;
+    entry.evict = std::move(evict);
+    entry.restore = std::move(restore);
+
+    entries_.push_front(std::move(entry));
+    index_[entries_.front().id] = entries_.begin();
+    return entries_.front().id;
+}
+
+void ResidencyManager::untrack(ResidencyId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(id);
+    if (found == index_.end()) return;
+
+    cpuBytes_.fetch_sub(found->second->cpuBytes);
+    gpuBytes_.fetch_sub(found->second->gpuBytes);
+    entries_.erase(found->second);
+    index_.erase(found);
+}
+
+void ResidencyManager::setBytes(ResidencyId id, size_t cpuBytes, size_t gpuBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(id);
+    if (found == index_.end()) return;
+
+    Entry& entry = *found->second;
+    cpuBytes_.fetch_sub(entry.cpuBytes);
+    gpuBytes_.fetch_sub(entry.gpuBytes);
+    entry.cpuBytes = cpuBytes;
+    entry.gpuBytes = gpuBytes;
+    cpuBytes_.fetch_add(cpuBytes);
+    gpuBytes_.fetch_add(gpuBytes);
+}
+
+void ResidencyManager::markResident(ResidencyId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(id);
+    if (found != index_.end() && found->second->state == State::Loading)
+        found->second->state = State::Resident;
+}
+
+void ResidencyManager::touch(ResidencyId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(id);
+    if (found == index_.end()) return;
+
+    // Move to the front: the back of the list is always the least recently drawn
+    entries_.splice(entries_.begin(), entries_, found->second);
+    Entry& entry = entries_.front();
+    entry.lastUsed = frame_;
+    if (entry.state == State::Evicted) entry.wanted = true;
+}
+
+size_t ResidencyManager::getGpuBytes() const {
+    return gpuBytes_.load() + TextureCache::instance().getResidentBytes();
+}
+
+size_t ResidencyManager::getAssetCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t ResidencyManager::getResidentCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const Entry& entry : entries_)
+        if (entry.state != State::Evicted) ++count;
+    return count;
+}
+
+int ResidencyManager::update() {
+    // Callbacks run without the lock: they upload, free meshes and report their new sizes
+    std::vector<std::function<void()>> restores;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++frame_;
+        for (Entry& entry : entries_) {
+            if (entry.state != State::Evicted || !entry.wanted) continue;
+            entry.state = State::Loading;
+            entry.wanted = false;
+            if (entry.restore) restores.push_back(entry.restore);
+        }
+    }
+    for (const std::function<void()>& restore : restores) restore();
+    restores_.fetch_add(restores.size());
+
+    int evicted = 0;
+    size_t budget = budget_.load();
+    while (budget > 0 && getGpuBytes() > budget) {
+        std::function<void()> evict;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+                // Everything further forward was drawn more recently
+                if (frame_ - it->lastUsed < kMinIdleFrames) break;
+                if (it->state != State::Resident || !it->evict) continue;
+
+                it->state = State::Evicted;
+                evict = it->evict;
+                std::cout << "Evicting " << it->name << " (" << it->gpuBytes / 1024 << " KB)" << std::endl;
+                break;
+            }
+        }
+        if (!evict) break; // whatever is left was drawn recently
+        evict();
+        ++evicted;
+    }
+    evictions_.fetch_add(evicted);
+    return evicted;
+}
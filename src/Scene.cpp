@@ -1,62 +1,57 @@
 #include "Scene.h"
+#include "Hash.h"
+#include "TextureCache.h"
 #include <vector>
 
 #include <algorithm> // Required for std::min
 
 #include <algorithm> // for std::min
 
-unsigned int createCheckeredTexture() {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
+// Baked once into .cache/textures with its full mip chain; later launches just map the container
+TextureHandle createCheckeredTexture() {
     // FIX 1: Increase resolution from 64 -> 1024
     // This keeps the texture sharp much further into the distance
     const int width = 1024;
     const int height = 1024;
-    std::vector<unsigned char> data(width * height * 3);
 
     // Adjust grid size since we increased resolution
-    int gridSize = 128; // Larger grid squares in pixels
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Simple math to create the checker pattern
-            bool isDark = ((x / gridSize) + (y / gridSize)) % 2 == 0;
-            unsigned char color = isDark ? 200 : 100;
-            
-            int index = (y * width + x) * 3;
-            data[index] = color;
-            data[index + 1] = color;
-            data[index + 2] = color;
+    const int gridSize = 128; // Larger grid squares in pixels
+
+    // The parameters are the "source": changing any of them rebakes
+    const int params[] = { width, height, gridSize, 200, 100 };
+    uint64_t sourceHash = Hash::fnv1a(params, sizeof(params));
+
+    ImageData image = TextureCache::loadBaked("checker", sourceHash, [&] {
+        RawImage raw;
+        raw.width = width;
+        raw.height = height;
+        raw.channels = 3;
+        raw.pixels = std::shared_ptr<unsigned char>(new unsigned char[width * height * 3], std::default_delete<unsigned char[]>());
+        unsigned char* data = raw.pixels.get();
+
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                // Simple math to create the checker pattern
+                bool isDark = ((x / gridSize) + (y / gridSize)) % 2 == 0;
+                unsigned char color = isDark ? 200 : 100;
+                
+                int index = (y * width + x) * 3;
+                data[index] = color;
+                data[index + 1] = color;
+                data[index + 2] = color;
+            }
         }
-    }
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data.data());
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // FIX 2: Set Anisotropic Filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        return raw;
+    });
 
-    // Force Anisotropy (Mac/OpenGL 4.1 compatible)
-    #ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
-        #define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
-        #define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
-    #endif
-
-    GLfloat maxAnisotropy = 0.0f;
-    glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(16.0f, maxAnisotropy));
-
-    return textureID;
+    // FIX 2: Anisotropic filtering and repeat wrapping are applied by the cache upload
+    return TextureCache::instance().acquire("generated:checker", image);
 }
 
 // Plane geometry
 unsigned int planeVAO = 0, planeVBO;
-unsigned int groundTexture = 0;
+TextureHandle groundTexture;
+RenderMaterial groundMaterial;
 
 void setupPlane() {
     float planeVertices[] = {
@@ -85,6 +80,8 @@ void setupPlane() {
     glBindVertexArray(0);
 
     groundTexture = createCheckeredTexture();
+    groundMaterial.textures = { groundTexture->id };
+    groundMaterial.samplers = { Uniform<int>("texture_diffuse1") };
 }
 
 Scene::Scene() {
@@ -94,32 +91,66 @@ Scene::Scene() {
 Scene::~Scene() {
     glDeleteVertexArrays(1, &planeVAO);
     glDeleteBuffers(1, &planeVBO);
-    glDeleteTextures(1, &groundTexture);
+    groundTexture.reset();
+    groundMaterial = RenderMaterial();
 }
 
 void Scene::Update(float deltaTime) {
 
 }
 
-void Scene::Draw(Shader* shader) {
+void Scene::Submit(RenderQueue& queue, Shader* shader, const LodView& lodView, const Frustum& frustum) {
+    // Ground Plane
+    if (planeVAO != 0) {
+        DrawPacket packet;
+        packet.shader = shader;
+        packet.material = &groundMaterial;
+        packet.VAO = planeVAO;
+        packet.count = 6;
+        packet.indexType = 0; // glDrawArrays
+        queue.Add(packet, UniformBuffers::MakeObject(glm::mat4(1.0f), glm::vec3(0.4f, 0.4f, 0.4f), true));
+    }
 
+    // World bounds of the models (whatever meshes have been uploaded so far). Models grow while
+    // they stream in, so the box is refit every frame; the tree only changes when it leaves its fat box.
+    // Evicted models keep their bounds: submitting one that comes back into view restores it.
+    int drawable = 0;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        SceneObject& object = objects[i];
+        if (!object.model || !object.model->bounds.IsValid()) continue;
+        ++drawable;
+
+        AABB box = object.model->bounds.Transformed(object.transform);
+        if (object.proxy < 0) object.proxy = bvh.CreateProxy(box, static_cast<int>(i));
+        else bvh.MoveProxy(object.proxy, box);
+    }
 
-    // Draw Ground Plane
-    if (planeVAO != 0) {
-        glm::mat4 model = glm::mat4(1.0f);
-        shader->setMat4("model", model);
-        
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, groundTexture);
-        shader->setBool("hasTexture", true);
-        shader->setVec3("baseColor", glm::vec3(0.4f, 0.4f, 0.4f));
-        shader->setInt("texture_diffuse1", 0); // Assuming texture unit 0
-
-        glBindVertexArray(planeVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
+    visible.clear();
+    bvh.Query(frustum, visible);
+    visibleCount = static_cast<int>(visible.size());
+    culledCount = drawable - visibleCount;
+
+    for (int index : visible) {
+        SceneObject& object = objects[index];
+        const Model& model = *object.model;
+
+        // Distance to the bounding sphere, so large models refine before the camera is inside them
+        float scale = std::max(glm::length(glm::vec3(object.transform[0])),
+                               std::max(glm::length(glm::vec3(object.transform[1])), glm::length(glm::vec3(object.transform[2]))));
+        glm::vec3 center = glm::vec3(object.transform * glm::vec4(model.bounds.GetCenter(), 1.0f));
+        float distance = glm::length(center - lodView.cameraPosition) - glm::length(model.bounds.GetExtents()) * scale;
+
+        const std::vector<float>& errors = model.GetLodErrors();
+        object.lod = LodSelector::select(errors.data(), static_cast<int>(errors.size()), scale, distance, lodView, object.lod);
+        model.Submit(queue, *shader, object.transform, object.lod);
     }
 }
 
 void Scene::Clear() {
+    objects.clear();
+    bvh.Clear();
+}
+
+void Scene::AddModel(std::shared_ptr<Model> model, const glm::mat4& transform) {
+    objects.push_back({ std::move(model), transform });
 }
\ No newline at end of file
@@ -1,8 +1,38 @@
 #include "Shader.h"
+#include "UniformBuffers.h"
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
-Shader::Shader(const std::string& filePath) {
+namespace {
+
+// Name -> UniformId for the whole process
+struct UniformRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, UniformId> ids;
+};
+
+UniformRegistry& registry() {
+    static UniformRegistry instance; // function-local: safe to use from other statics' initializers
+    return instance;
+}
+
+} // namespace
+
+UniformId Shader::uniformId(const std::string& name) {
+    UniformRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.ids.find(name);
+    if (it != r.ids.end()) return it->second;
+
+    UniformId id = static_cast<UniformId>(r.ids.size());
+    r.ids.emplace(name, id);
+    return id;
+}
+
+Shader::Shader(const std::string& filePath) : ID(0), name(filePath) {
     std::ifstream stream(filePath);
     
     // Check if file exists
@@ -26,6 +56,18 @@ Shader::Shader(const std::string& filePath) {
         else if (line.find("#shader fragment") != std::string::npos) {
             type = ShaderType::FRAGMENT;
         }
+        else if (line.rfind("#include", 0) == 0 && type != ShaderType::NONE) {
+            // #include "file.glsl": spliced in from the shader's directory (shared uniform blocks)
+            size_t first = line.find('"'), last = line.rfind('"');
+            std::ifstream include;
+            if (first != std::string::npos && last != first)
+                include.open(filePath.substr(0, filePath.find_last_of("/\\") + 1) + line.substr(first + 1, last - first - 1));
+            if (!include.is_open()) {
+                std::cout << "ERROR::SHADER::INCLUDE_NOT_FOUND: " << line << " in " << filePath << std::endl;
+                continue;
+            }
+            ss[(int)type] << include.rdbuf() << '\n';
+        }
         else {
             if (type != ShaderType::NONE) {
                 ss[(int)type] << line << '\n';
@@ -33,9 +75,15 @@ Shader::Shader(const std::string& filePath) {
         }
     }
 
-    std::string vertexCode = ss[0].str();
-    std::string fragmentCode = ss[1].str();
+    compile(ss[0].str(), ss[1].str());
+}
+
+Shader::Shader(const std::string& vertexSource, const std::string& fragmentSource, const std::string& name)
+    : ID(0), name(name) {
+    compile(vertexSource, fragmentSource);
+}
 
+void Shader::compile(const std::string& vertexCode, const std::string& fragmentCode) {
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
 
@@ -63,6 +111,51 @@ Shader::Shader(const std::string& filePath) {
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    reflectUniforms();
+}
+
+void Shader::reflectUniforms() {
+    // Shared blocks go to fixed binding points so one buffer bind serves every program
+    GLuint frameBlock = glGetUniformBlockIndex(ID, "FrameData");
+    if (frameBlock != GL_INVALID_INDEX) glUniformBlockBinding(ID, frameBlock, FRAME_BLOCK_BINDING);
+    GLuint objectBlock = glGetUniformBlockIndex(ID, "ObjectData");
+    if (objectBlock != GL_INVALID_INDEX) glUniformBlockBinding(ID, objectBlock, OBJECT_BLOCK_BINDING);
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> buffer(std::max(maxLength, 1));
+    auto add = [this](const std::string& name, int loc) {
+        UniformId id = uniformId(name);
+        if (id >= (int)locations.size()) locations.resize(id + 1, -1);
+        locations[id] = loc;
+    };
+
+    for (GLint i = 0; i < count; ++i) {
+        GLint size = 0;
+        GLenum type = 0;
+        GLsizei length = 0;
+        glGetActiveUniform(ID, (GLuint)i, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), length);
+
+        int loc = glGetUniformLocation(ID, name.c_str());
+        if (loc < 0) continue; // block members have no location
+
+        add(name, loc);
+
+        // Arrays are reported as "name[0]": make "name" and every element addressable too
+        size_t bracket = name.find('[');
+        if (bracket != std::string::npos) {
+            std::string base = name.substr(0, bracket);
+            add(base, loc);
+            for (GLint e = 1; e < size; ++e) {
+                std::string element = base + "[" + std::to_string(e) + "]";
+                add(element, glGetUniformLocation(ID, element.c_str()));
+            }
+        }
+    }
 }
 
 void Shader::use() { 
@@ -70,22 +163,22 @@ void Shader::use() {
 }
 
 void Shader::setBool(const std::string &name, bool value) const {         
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+    glUniform1i(location(uniformId(name)), (int)value); 
 }
 void Shader::setInt(const std::string &name, int value) const { 
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+    glUniform1i(location(uniformId(name)), value); 
 }
 void Shader::setFloat(const std::string &name, float value) const { 
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+    glUniform1f(location(uniformId(name)), value); 
 }
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const { 
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+    glUniform3fv(location(uniformId(name)), 1, &value[0]); 
 }
 void Shader::setVec3(const std::string &name, float x, float y, float z) const { 
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+    glUniform3f(location(uniformId(name)), x, y, z); 
 }
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix4fv(location(uniformId(name)), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::checkCompileErrors(unsigned int shader, std::string type) {
@@ -95,13 +188,13 @@ void Shader::checkCompileErrors(unsigned int shader, std::string type) {
         glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
         if (!success) {
             glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-            std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << " in " << name << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
         }
     } else {
         glGetProgramiv(shader, GL_LINK_STATUS, &success);
         if (!success) {
             glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-            std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << " in " << name << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "TextureCache.h"
+#include "Hash.h"
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+std::atomic<bool> TextureCache::compression_{false};
+
+TextureCache& TextureCache::instance() {
+    static TextureCache cache;
+    return cache;
+}
+
+TextureCache::~TextureCache() {
+    // Runs after the GL context is gone: nothing left to delete through GL
+}
+
+std::string TextureCache::keyFor(const std::string& path, const std::string& directory,
+                                 const unsigned char* embeddedData, size_t embeddedSize) {
+    // Embedded textures: '*N' is only unique within one file, so key on the bytes
+    if (!path.empty() && path[0] == '*')
+        return "embedded:" + Hash::toHex(Hash::fnv1a(embeddedData, embeddedData ? embeddedSize : 0));
+
+    // Files: resolve "textures/../a.png", "./a.png" etc. to one spelling
+    std::error_code ec;
+    std::filesystem::path resolved = std::filesystem::weakly_canonical(std::filesystem::path(directory) / path, ec);
+    if (ec) resolved = (std::filesystem::path(directory) / path).lexically_normal();
+    return "file:" + resolved.generic_string();
+}
+
+ImageData TextureCache::loadBaked(const std::string& name, uint64_t sourceHash, const std::function<RawImage()>& produce) {
+    std::string containerPath = TextureContainer::pathFor(name);
+
+    ImageData image;
+    if (TextureContainer::read(containerPath, sourceHash, image)) {
+        // Baked compressed but this GPU can't sample BC: rebake uncompressed
+        if (!TextureContainer::isCompressed(image.format) || isCompressionEnabled())
+            return image;
+    }
+
+    RawImage raw = produce();
+    if (!raw.pixels) return ImageData();
+
+    image = TextureContainer::bake(raw, isCompressionEnabled());
+    if (!TextureContainer::write(containerPath, sourceHash, image))
+        std::cout << "ERROR::TEXTURECACHE::WRITE_FAILED " << containerPath << std::endl;
+    return image;
+}
+
+ImageData TextureCache::loadFile(const std::string& filename, bool flip) {
+    uint64_t sourceHash = 0;
+    if (!TextureContainer::hashSource(filename, flip, sourceHash)) {
+        std::cout << "Texture failed to load at path: " << filename << std::endl;
+        return ImageData();
+    }
+
+    std::error_code ec;
+    std::filesystem::path resolved = std::filesystem::weakly_canonical(filename, ec);
+    std::string name = ec ? filename : resolved.generic_string();
+
+    return loadBaked(name, sourceHash, [&] {
+        RawImage raw;
+        // Thread-local flag: loader threads decode concurrently
+        stbi_set_flip_vertically_on_load_thread(flip);
+        unsigned char* data = stbi_load(filename.c_str(), &raw.width, &raw.height, &raw.channels, 0);
+        stbi_set_flip_vertically_on_load_thread(false);
+
+        if (data) raw.pixels = std::shared_ptr<unsigned char>(data, stbi_image_free);
+        else std::cout << "Texture failed to load at path: " << filename << std::endl;
+        return raw;
+    });
+}
+
+ImageData TextureCache::loadEmbedded(const unsigned char* data, size_t size, bool flip) {
+    uint64_t sourceHash = Hash::fnv1a(data, size, Hash::fnv1a(flip ? "flip" : "noflip"));
+    std::string name = "embedded_" + Hash::toHex(Hash::fnv1a(data, size));
+
+    return loadBaked(name, sourceHash, [&] {
+        RawImage raw;
+        stbi_set_flip_vertically_on_load_thread(flip);
+        unsigned char* pixels = stbi_load_from_memory(data, static_cast<int>(size), &raw.width, &raw.height, &raw.channels, 0);
+        stbi_set_flip_vertically_on_load_thread(false);
+
+        if (pixels) raw.pixels = std::shared_ptr<unsigned char>(pixels, stbi_image_free);
+        else std::cout << "Embedded texture failed to load" << std::endl;
+        return raw;
+    });
+}
+
+void TextureCache::initialize() {
+    // Core in every desktop driver that matters, but it is still an extension in GL 4.1
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    bool s3tc = false;
+    for (GLint i = 0; i < count && !s3tc; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        s3tc = name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0;
+    }
+    setCompressionEnabled(s3tc);
+}
+
+TextureHandle TextureCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = textures_.find(key);
+    return it != textures_.end() ? it->second.lock() : nullptr;
+}
+
+TextureHandle TextureCache::acquire(const std::string& key, const ImageData& image) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = textures_.find(key);
+    if (it != textures_.end()) {
+        if (TextureHandle existing = it->second.lock()) {
+            hits_.fetch_add(1);
+            return existing;
+        }
+    }
+
+    misses_.fetch_add(1);
+
+    CachedTexture* texture = new CachedTexture();
+    texture->id = upload(image);
+    texture->width = image.width;
+    texture->height = image.height;
+    texture->bytes = image.bytes();
+    texture->compressed = TextureContainer::isCompressed(image.format);
+    texture->key = key;
+    residentBytes_.fetch_add(texture->bytes);
+
+    TextureHandle handle(texture, [this](const CachedTexture* released) { release(released); });
+    textures_[key] = handle;
+    return handle;
+}
+
+void TextureCache::release(const CachedTexture* texture) {
+    residentBytes_.fetch_sub(texture->bytes);
+    {
+        std::lock_guard<std::mutex> lock(releaseMutex_);
+        released_.push_back(texture->id);
+    }
+    delete texture;
+}
+
+void TextureCache::collect() {
+    std::vector<unsigned int> ids;
+    {
+        std::lock_guard<std::mutex> lock(releaseMutex_);
+        ids.swap(released_);
+    }
+    if (ids.empty()) return;
+
+    glDeleteTextures(static_cast<GLsizei>(ids.size()), ids.data());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = textures_.begin(); it != textures_.end();) {
+        if (it->second.expired()) it = textures_.erase(it);
+        else ++it;
+    }
+}
+
+size_t TextureCache::getTextureCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(textures_.begin(), textures_.end(),
+                                              [](const auto& entry) { return !entry.second.expired(); }));
+}
+
+unsigned int TextureCache::upload(const ImageData& image) {
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+
+    if (!image.empty()) {
+        #ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+        #define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+        #define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+        #endif
+
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB8/R8 rows are tightly packed
+
+        // Every level comes from the container: no glGenerateMipmap
+        for (size_t level = 0; level < image.levels.size(); ++level) {
+            const TextureLevel& l = image.levels[level];
+            switch (image.format) {
+                case TextureFormat::BC1:
+                    glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, l.width, l.height, 0, (GLsizei)l.size, l.data);
+                    break;
+                case TextureFormat::BC3:
+                    glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, l.width, l.height, 0, (GLsizei)l.size, l.data);
+                    break;
+                case TextureFormat::R8:
+                    glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_RED, l.width, l.height, 0, GL_RED, GL_UNSIGNED_BYTE, l.data);
+                    break;
+                case TextureFormat::RGB8:
+                    glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_RGB, l.width, l.height, 0, GL_RGB, GL_UNSIGNED_BYTE, l.data);
+                    break;
+                case TextureFormat::RGBA8:
+                    glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_RGBA, l.width, l.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, l.data);
+                    break;
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.levels.size()) - 1);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        // Wrapping: Repeat ensures we don't get ugly edges if UVs go out of bounds
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        // Filtering: Linear Mipmap Linear is the highest quality standard filtering
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // 1. Manually define the constants if the header is missing them
+        #ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
+        #define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
+        #define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
+        #endif
+
+        // 2. Query and Apply (No #ifdef check, just run it)
+        GLfloat maxAnisotropy = 0.0f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+
+        // Clamp to 16.0f (or whatever the GPU supports) and apply
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(16.0f, maxAnisotropy));
+    }
+
+    return textureID;
+}
@@ -0,0 +1,351 @@
+#include "TextureContainer.h"
+#include "FileSystem.h"
+#include "Hash.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+// --- File Layout ---
+// Header | LevelRecord[levelCount] | level data (16-byte aligned, level 0 first)
+
+namespace {
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint64_t sourceHash;
+    uint64_t fileSize;
+};
+
+struct LevelRecord {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+const char kMagic[4] = { 'T', 'T', 'E', 'X' };
+
+int channelCount(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R8: return 1;
+        case TextureFormat::RGB8: return 3;
+        default: return 4;
+    }
+}
+
+// --- Block Compression ---
+// Bounding-box endpoint selection (fast, decent quality for colour maps)
+
+uint16_t pack565(int r, int g, int b) {
+    return static_cast<uint16_t>(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+}
+
+void unpack565(uint16_t c, int rgb[3]) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+void encodeColorBlock(const unsigned char block[16][4], unsigned char* out) {
+    int lo[3] = { 255, 255, 255 }, hi[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            lo[c] = std::min(lo[c], static_cast<int>(block[i][c]));
+            hi[c] = std::max(hi[c], static_cast<int>(block[i][c]));
+        }
+    }
+    // Inset the box slightly: endpoints at the extremes waste precision on outliers
+    for (int c = 0; c < 3; ++c) {
+        int inset = (hi[c] - lo[c]) / 16;
+        lo[c] += inset;
+        hi[c] -= inset;
+    }
+
+    uint16_t c0 = pack565(hi[0], hi[1], hi[2]);
+    uint16_t c1 = pack565(lo[0], lo[1], lo[2]);
+    uint32_t indices = 0;
+
+    // c0 > c1 selects the four-colour mode
+    if (c0 < c1) std::swap(c0, c1);
+    if (c0 != c1) {
+        int palette[4][3];
+        unpack565(c0, palette[0]);
+        unpack565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 1 << 30;
+            for (int p = 0; p < 4; ++p) {
+                int dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+                int dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist) { bestDist = dist; best = p; }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+    }
+
+    out[0] = c0 & 0xFF; out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF; out[3] = c1 >> 8;
+    for (int b = 0; b < 4; ++b) out[4 + b] = (indices >> (8 * b)) & 0xFF;
+}
+
+void encodeAlphaBlock(const unsigned char block[16][4], unsigned char* out) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max(a0, static_cast<int>(block[i][3]));
+        a1 = std::min(a1, static_cast<int>(block[i][3]));
+    }
+
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        // a0 > a1 selects the eight-value mode
+        int palette[8] = { a0, a1 };
+        for (int i = 1; i < 7; ++i) palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 1 << 30;
+            for (int p = 0; p < 8; ++p) {
+                int dist = std::abs(block[i][3] - palette[p]);
+                if (dist < bestDist) { bestDist = dist; best = p; }
+            }
+            indices |= static_cast<uint64_t>(best) << (3 * i);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(a0);
+    out[1] = static_cast<unsigned char>(a1);
+    for (int b = 0; b < 6; ++b) out[2 + b] = (indices >> (8 * b)) & 0xFF;
+}
+
+void compressLevel(const unsigned char* pixels, int width, int height, int channels, TextureFormat format, unsigned char* out) {
+    size_t blockBytes = format == TextureFormat::BC3 ? 16 : 8;
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            // Gather the 4x4 block, clamping at the edges of small/odd levels
+            unsigned char block[16][4];
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    int sx = std::min(bx + x, width - 1), sy = std::min(by + y, height - 1);
+                    const unsigned char* src = pixels + (static_cast<size_t>(sy) * width + sx) * channels;
+                    unsigned char* dst = block[y * 4 + x];
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                    dst[3] = channels == 4 ? src[3] : 255;
+                }
+            }
+
+            if (format == TextureFormat::BC3) {
+                encodeAlphaBlock(block, out);
+                encodeColorBlock(block, out + 8);
+            } else {
+                encodeColorBlock(block, out);
+            }
+            out += blockBytes;
+        }
+    }
+}
+
+void downsample(const unsigned char* src, int width, int height, int channels, unsigned char* dst, int dstWidth, int dstHeight) {
+    for (int y = 0; y < dstHeight; ++y) {
+        int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < dstWidth; ++x) {
+            int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+            for (int c = 0; c < channels; ++c) {
+                int sum = src[(static_cast<size_t>(y0) * width + x0) * channels + c] +
+                          src[(static_cast<size_t>(y0) * width + x1) * channels + c] +
+                          src[(static_cast<size_t>(y1) * width + x0) * channels + c] +
+                          src[(static_cast<size_t>(y1) * width + x1) * channels + c];
+                dst[(static_cast<size_t>(y) * dstWidth + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+bool inRange(uint64_t offset, uint64_t size, size_t fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+size_t alignUp(size_t value) {
+    return (value + 15) & ~static_cast<size_t>(15);
+}
+
+} // namespace
+
+size_t ImageData::bytes() const {
+    size_t total = 0;
+    for (const TextureLevel& level : levels) total += level.size;
+    return total;
+}
+
+size_t TextureContainer::levelSize(TextureFormat format, int width, int height) {
+    if (isCompressed(format)) {
+        size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+        return blocks * (format == TextureFormat::BC3 ? 16 : 8);
+    }
+    return static_cast<size_t>(width) * height * channelCount(format);
+}
+
+std::string TextureContainer::pathFor(const std::string& name) {
+    std::string stem = std::filesystem::path(name).stem().string();
+    return FileSystem::getCachePath("textures/" + stem + "_" + Hash::toHex(Hash::fnv1a(name)) + ".ttex");
+}
+
+bool TextureContainer::hashSource(const std::string& filename, bool flip, uint64_t& hash) {
+    hash = Hash::fnv1a(flip ? "flip" : "noflip");
+    return Hash::file(filename, hash);
+}
+
+ImageData TextureContainer::bake(const RawImage& source, bool compress) {
+    ImageData image;
+    if (!source.pixels || source.width <= 0 || source.height <= 0) return image;
+
+    int channels = source.channels;
+    if (channels == 2) channels = 1; // grey+alpha is rare for model textures; keep the grey
+    image.width = source.width;
+    image.height = source.height;
+    image.format = channels == 1 ? TextureFormat::R8 : channels == 3 ? TextureFormat::RGB8 : TextureFormat::RGBA8;
+    if (compress && channels >= 3)
+        image.format = channels == 3 ? TextureFormat::BC1 : TextureFormat::BC3;
+
+    // Level dimensions and the packed size of the whole chain
+    std::vector<std::pair<int, int>> dims;
+    for (int w = source.width, h = source.height;; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+        dims.emplace_back(w, h);
+        if (w == 1 && h == 1) break;
+    }
+    size_t total = 0;
+    for (const auto& d : dims) total += alignUp(levelSize(image.format, d.first, d.second));
+
+    auto storage = std::make_shared<std::vector<unsigned char>>(total);
+
+    // Uncompressed working copy of the current level (channel count already normalised)
+    std::vector<unsigned char> current(static_cast<size_t>(source.width) * source.height * channels);
+    if (channels == source.channels) {
+        std::memcpy(current.data(), source.pixels.get(), current.size());
+    } else {
+        for (size_t i = 0; i < static_cast<size_t>(source.width) * source.height; ++i)
+            current[i] = source.pixels.get()[i * source.channels];
+    }
+
+    size_t offset = 0;
+    std::vector<unsigned char> next;
+    for (size_t level = 0; level < dims.size(); ++level) {
+        int w = dims[level].first, h = dims[level].second;
+        unsigned char* out = storage->data() + offset;
+        size_t size = levelSize(image.format, w, h);
+
+        if (isCompressed(image.format)) compressLevel(current.data(), w, h, channels, image.format, out);
+        else std::memcpy(out, current.data(), size);
+
+        image.levels.push_back({ w, h, out, size });
+        offset += alignUp(size);
+
+        if (level + 1 < dims.size()) {
+            int nw = dims[level + 1].first, nh = dims[level + 1].second;
+            next.resize(static_cast<size_t>(nw) * nh * channels);
+            downsample(current.data(), w, h, channels, next.data(), nw, nh);
+            current.swap(next);
+        }
+    }
+
+    image.storage = storage;
+    return image;
+}
+
+bool TextureContainer::read(const std::string& path, uint64_t sourceHash, ImageData& image) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) return false;
+
+    const unsigned char* base = file->data();
+    size_t size = file->size();
+
+    if (size < sizeof(FileHeader)) return false;
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kVersion ||
+        header.sourceHash != sourceHash || header.fileSize != size ||
+        header.format < static_cast<uint32_t>(TextureFormat::R8) || header.format > static_cast<uint32_t>(TextureFormat::BC3) ||
+        header.levelCount == 0 || !inRange(sizeof(FileHeader), header.levelCount * sizeof(LevelRecord), size)) {
+        return false;
+    }
+
+    ImageData result;
+    result.format = static_cast<TextureFormat>(header.format);
+    result.width = static_cast<int>(header.width);
+    result.height = static_cast<int>(header.height);
+
+    const LevelRecord* records = reinterpret_cast<const LevelRecord*>(base + sizeof(FileHeader));
+    for (uint32_t i = 0; i < header.levelCount; ++i) {
+        const LevelRecord& record = records[i];
+        if (!inRange(record.offset, record.size, size) ||
+            record.size != levelSize(result.format, static_cast<int>(record.width), static_cast<int>(record.height))) {
+            return false;
+        }
+        result.levels.push_back({ static_cast<int>(record.width), static_cast<int>(record.height), base + record.offset, record.size });
+    }
+
+    result.storage = file;
+    image = std::move(result);
+    return true;
+}
+
+bool TextureContainer::write(const std::string& path, uint64_t sourceHash, const ImageData& image) {
+    if (image.empty()) return false;
+
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.format = static_cast<uint32_t>(image.format);
+    header.width = static_cast<uint32_t>(image.width);
+    header.height = static_cast<uint32_t>(image.height);
+    header.levelCount = static_cast<uint32_t>(image.levels.size());
+    header.sourceHash = sourceHash;
+
+    std::vector<LevelRecord> records;
+    size_t offset = alignUp(sizeof(FileHeader) + image.levels.size() * sizeof(LevelRecord));
+    for (const TextureLevel& level : image.levels) {
+        records.push_back({ offset, level.size, static_cast<uint32_t>(level.width), static_cast<uint32_t>(level.height) });
+        offset = alignUp(offset + level.size);
+    }
+    header.fileSize = offset;
+
+    std::vector<unsigned char> bytes(offset, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), records.data(), records.size() * sizeof(LevelRecord));
+    for (size_t i = 0; i < image.levels.size(); ++i)
+        std::memcpy(bytes.data() + records[i].offset, image.levels[i].data, image.levels[i].size);
+
+    // Write to a temporary name and rename, so readers never map a half-written file.
+    // Per-thread name: two loader threads may bake the same shared texture at once.
+    std::string tempPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) return false;
+        stream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        if (!stream) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
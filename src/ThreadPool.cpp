@@ -0,0 +1,100 @@
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    workers_.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i)
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskReady_.notify_all();
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    taskReady_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return tasks_.empty() && active_ == 0; });
+}
+
+void ThreadPool::workerLoop() {
+    Profiler::setThreadName("Worker");
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskReady_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++active_;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_;
+            if (tasks_.empty() && active_ == 0)
+                idle_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int, int)>& fn) {
+    if (count <= 0) return;
+
+    int chunks = std::min(count, static_cast<int>(size()) + 1);
+    if (chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Completion latch for this call only (other enqueued work is not waited on)
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    int remaining = chunks - 1;
+
+    int chunkSize = count / chunks;
+    int extra = count % chunks;
+    int begin = 0;
+    int callerBegin = 0, callerEnd = 0;
+
+    for (int c = 0; c < chunks; ++c) {
+        int end = begin + chunkSize + (c < extra ? 1 : 0);
+        if (c == 0) {
+            callerBegin = begin;
+            callerEnd = end;
+        } else {
+            enqueue([&, begin, end] {
+                fn(begin, end);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (--remaining == 0) doneCv.notify_one();
+            });
+        }
+        begin = end;
+    }
+
+    fn(callerBegin, callerEnd);
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [&] { return remaining == 0; });
+}
@@ -1,37 +1,75 @@
 #include "ToonApp.h"
 #include "FileSystem.h"
 #include "Physics.h"
+#include "CameraPath.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib> 
 #include <ctime>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
 
 
 
-ToonApp::ToonApp(int width, int height, const char* title) 
-    : scrWidth(width), scrHeight(height), firstMouse(true), mouseCaptured(true),
-      lightPos(2.0f, 8.0f, 5.0f), lightColor(1.0f, 1.0f, 1.0f), bgColor(1.0f, 1.0f, 1.0f)
+ToonApp::ToonApp(const AppConfig& appConfig) 
+    : config(appConfig), scrWidth(appConfig.width), scrHeight(appConfig.height),
+      lightPos(2.0f, 8.0f, 5.0f), lightColor(1.0f, 1.0f, 1.0f), bgColor(1.0f, 1.0f, 1.0f), firstMouse(true), mouseCaptured(true)
 {
     // 1. Initialize Window & OpenGL
-    InitGLFW();
+    Profiler::setThreadName("Main");
+    if (config.headless) InitHeadless();
+    else InitGLFW();
 
     // 2. Create Systems & Assets
+    TextureCache::instance().initialize(); // before anything bakes textures
+    uniformBuffers = std::make_unique<UniformBuffers>();
+    renderQueue = std::make_unique<RenderQueue>();
     camera = std::make_unique<Camera>(glm::vec3(0.0f, 2.0f, 10.0f));
-    lastX = width / 2.0f;
-    lastY = height / 2.0f;
+    lastX = scrWidth / 2.0f;
+    lastY = scrHeight / 2.0f;
     
     regularShader = std::make_shared<Shader>(FileSystem::getPath("shaders/regularshader.glsl"));
-    postProcessShader = std::make_shared<Shader>(FileSystem::getPath("shaders/passthrough.glsl"));
+    geomShader = std::make_shared<Shader>(FileSystem::getPath("shaders/instancedshader.glsl"));
 
-    gameBuffer = std::make_unique<FrameBuffer>(scrWidth, scrHeight);
+    renderTargets = std::make_unique<RenderTargetPool>();
+    gameBuffer = std::make_unique<FrameBuffer>(*renderTargets);
+    renderWidth = pendingWidth = scrWidth;
+    renderHeight = pendingHeight = scrHeight;
+
+    // Toon look: quantize and outline fuse into one draw, FXAA runs on their output.
+    // All off by default (plain copy to the screen); toggled from the UI.
+    postProcess = std::make_unique<PostProcessGraph>(FileSystem::getPath("shaders/post"), *renderTargets);
+    postProcess->AddPass("quantize", true, { { "quantizeLevels", 8.0f, 2.0f, 32.0f } }, false);
+    postProcess->AddPass("outline", true, { { "outlineWidth", 1.0f, 1.0f, 4.0f }, { "outlineThreshold", 0.05f, 0.005f, 0.5f } }, false);
+    postProcess->AddPass("fxaa", false, { { "fxaaStrength", 1.0f, 0.0f, 1.0f } }, false);
 
     activeScene = std::make_unique<Scene>();
 
+    // Models import on worker threads and upload over the next frames; the window shows immediately
+    assetLoader = std::make_unique<AssetLoader>();
+    backpackModel = assetLoader->loadModel(FileSystem::getPath("assets/backpack/backpack.obj"));
+    glm::mat4 backpackTransform = glm::translate(glm::mat4(1.0f), glm::vec3(3.0f, 1.0f, 0.0f));
+    activeScene->AddModel(backpackModel, glm::scale(backpackTransform, glm::vec3(0.5f)));
 
     // assets/google-deepmind mujoco_menagerie main kuka_iiwa_14
     mujocoSim = std::make_unique<MujocoSim>();
     mujocoSim->loadModel(FileSystem::getPath("assets/google-deepmind mujoco_menagerie main kuka_iiwa_14/iiwa14.xml"));
 
+    geomRenderer = std::make_unique<GeomRenderer>();
+    geomRenderer->Build(mujocoSim->getModel());
+
+    // Headless renders step the sim in lockstep with the frames instead (see Update)
+    if (config.headless) return;
+
+    // Physics runs at its own fixed rate; the render loop only reads published poses
+    physicsThread = std::make_unique<PhysicsThread>(*mujocoSim);
+    physicsThread->start();
+
     // 3. Initialize UI
     InitImGui();
 
@@ -46,6 +84,24 @@ ToonApp::ToonApp(int width, int height, const char* title)
 }
 
 ToonApp::~ToonApp() {
+    // Stop workers and release GL objects while the context still exists
+    assetLoader.reset();
+    physicsThread.reset();
+    geomRenderer.reset();
+    activeScene.reset();
+    backpackModel.reset();
+    uniformBuffers.reset();
+    GeometryPool::DestroyAll(); // after every Model is gone
+    TextureCache::instance().collect();
+    frameCapture.stop(); // finishes pending readbacks and writes
+    Profiler::instance().shutdownGpu();
+    dynamicResolution.shutdownGpu();
+    gameBuffer.reset();
+    postProcess.reset();
+    renderTargets.reset();
+    if (outputFbo) glDeleteFramebuffers(1, &outputFbo);
+    if (outputColor) glDeleteRenderbuffers(1, &outputColor);
+
     // Clean up globals
     if (window) {
         ImGui_ImplOpenGL3_Shutdown();
@@ -54,6 +110,7 @@ ToonApp::~ToonApp() {
         glfwDestroyWindow(window);
         glfwTerminate();
     }
+    headlessContext.reset();
 }
 
 void ToonApp::InitGLFW() {
@@ -63,7 +120,7 @@ void ToonApp::InitGLFW() {
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 
-    window = glfwCreateWindow(scrWidth, scrHeight, "Toon Engine", NULL, NULL);
+    window = glfwCreateWindow(scrWidth, scrHeight, config.title.c_str(), NULL, NULL);
     if (!window) {
         std::cout << "Failed to create GLFW window" << std::endl;
         glfwTerminate();
@@ -91,6 +148,34 @@ void ToonApp::InitGLFW() {
     
 }
 
+void ToonApp::InitHeadless() {
+    headlessContext = std::make_unique<HeadlessContext>();
+    if (!headlessContext->Create(scrWidth, scrHeight)) {
+        std::cout << "Failed to create headless GL context" << std::endl;
+        exit(-1);
+    }
+    std::cout << "Headless: " << headlessContext->GetBackend() << ", "
+              << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << std::endl;
+
+    // Stands in for the window's default framebuffer: the post pass draws here and frames are read back from it
+    glGenRenderbuffers(1, &outputColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, outputColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, scrWidth, scrHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &outputFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, outputColor);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "ERROR::HEADLESS::OUTPUT_FRAMEBUFFER_INCOMPLETE" << std::endl;
+        exit(-1);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glViewport(0, 0, scrWidth, scrHeight);
+    glEnable(GL_DEPTH_TEST);
+}
+
 void ToonApp::InitImGui() {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -100,29 +185,130 @@ void ToonApp::InitImGui() {
 }
 
 void ToonApp::Run() {
+    if (config.headless) {
+        RunHeadless();
+        return;
+    }
+
     while (!glfwWindowShouldClose(window)) {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        // Collects last frame's scopes (and older GPU timings) before this frame records any
+        Profiler::instance().beginFrame();
+        PROFILE_SCOPE("Frame");
+
+        // Double precision steady clock: a float glfwGetTime() loses resolution in long sessions
+        deltaTime = static_cast<float>(frameStats.tick(static_cast<float>(Profiler::instance().getLastGpuFrameMs())));
 
         ProcessInput();
         Update();
         
         // Safety check before render loop
         if (gameBuffer) {
-            gameBuffer->Bind();
+            renderTargets->BeginFrame();
+            UpdateRenderSize();
+
+            // Scene and post process are timed together; the scale follows their GPU time
+            dynamicResolution.beginFrame();
+            gameBuffer->Bind(renderWidth, renderHeight, dynamicResolution.getScale());
             RenderScene();
-            gameBuffer->DrawToScreen(*postProcessShader);
+            RenderPostProcess(0);
+            dynamicResolution.endFrame();
+
+            // Before the UI is drawn over it; the pixels arrive a few frames later
+            frameCapture.capture(0, scrWidth, scrHeight, gameBuffer->GetFBO(), gameBuffer->viewportWidth,
+                                 gameBuffer->viewportHeight);
+            gameBuffer->Release();
         }
         
         RenderUI();
 
-        glfwSwapBuffers(window);
+        {
+            PROFILE_SCOPE("Swap Buffers");
+            glfwSwapBuffers(window);
+        }
         glfwPollEvents();
     }
 }
 
+void ToonApp::RunHeadless() {
+    CameraPath path;
+    if (!config.cameraPath.empty() && !path.Load(config.cameraPath))
+        throw std::runtime_error("Could not load camera path " + config.cameraPath);
+    const double frameTime = 1.0 / std::max(config.fps, 1.0);
+    if (path.IsEmpty())
+        path = CameraPath::Orbit(glm::vec3(1.5f, 1.0f, 0.0f), 10.0f, 2.0f, static_cast<float>(config.frames * frameTime));
+
+    // Readbacks overlap the next frames' rendering; nothing is dropped, the writers are waited for instead
+    if (!config.outputDir.empty()) {
+        FrameCapture::Settings settings;
+        settings.outputDir = config.outputDir;
+        settings.captureDepth = config.captureDepth;
+        settings.dropWhenBehind = false;
+        settings.pngThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        settings.fps = config.fps;
+        if (!frameCapture.start(settings)) throw std::runtime_error("Could not write to " + config.outputDir);
+    }
+
+    // Streaming would let models pop in part way through; every batch frame shows the whole scene
+    while (!assetLoader->isIdle()) {
+        assetLoader->update(100.0f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (int frame = 0; frame < config.frames; ++frame) {
+        Profiler::instance().beginFrame();
+        PROFILE_SCOPE("Frame");
+
+        // Simulated time, not wall time: output is the same however slow the renderer is.
+        // The wall time still goes into the stats.
+        frameStats.tick(static_cast<float>(Profiler::instance().getLastGpuFrameMs()));
+        deltaTime = frame > 0 ? static_cast<float>(frameTime) : 0.0f;
+        simulatedTime = frame * frameTime;
+
+        path.Apply(*camera, static_cast<float>(simulatedTime));
+        Update();
+
+        renderTargets->BeginFrame();
+        gameBuffer->Bind(renderWidth, renderHeight);
+        RenderScene();
+        RenderPostProcess(outputFbo);
+
+        frameCapture.capture(outputFbo, scrWidth, scrHeight, gameBuffer->GetFBO(), gameBuffer->viewportWidth,
+                             gameBuffer->viewportHeight);
+        gameBuffer->Release();
+    }
+    frameCapture.stop();
+
+    FrameStats::Summary stats = frameStats.getSummary();
+    std::cout << "Headless: " << config.frames << " frames, " << stats.averageMs << " ms avg, p95 " << stats.p95Ms
+              << " ms, max " << stats.maxMs << " ms" << std::endl;
+    if (!config.outputDir.empty()) {
+        std::string file = (std::filesystem::path(config.outputDir) / "frame_stats.json").string();
+        if (!frameStats.writeJson(file)) std::cout << "ERROR::FRAMESTATS::WRITE_FAILED " << file << std::endl;
+    }
+}
+
+void ToonApp::ToggleCapture() {
+    if (frameCapture.isRecording()) {
+        frameCapture.stop();
+        std::cout << "Capture: stopped, " << frameCapture.getWrittenFrames() << " frames written, "
+                  << frameCapture.getDroppedFrames() << " dropped" << std::endl;
+        return;
+    }
+
+    // One directory per recording
+    char name[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(name, sizeof(name), "capture_%Y%m%d_%H%M%S", std::localtime(&now));
+
+    FrameCapture::Settings settings;
+    settings.outputDir = name;
+    settings.format = captureRaw ? FrameCapture::Format::Raw : FrameCapture::Format::Png;
+    settings.captureDepth = captureDepth;
+    if (frameCapture.start(settings)) std::cout << "Capture: recording to " << name << std::endl;
+}
+
 void ToonApp::ProcessInput() {
+    PROFILE_SCOPE("Process Input");
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
@@ -137,47 +323,220 @@ void ToonApp::ProcessInput() {
 }
 
 void ToonApp::Update() {
+    PROFILE_SCOPE("Update");
+
+    // Finished imports: GL uploads, bounded so loading never causes a hitch
+    {
+        PROFILE_SCOPE("Asset Uploads");
+        assetLoader->update(uploadBudgetMs);
+    }
+    // Evicts models not drawn lately while over the VRAM budget, before collect() frees their textures
+    ResidencyManager::instance().update();
+    TextureCache::instance().collect();
+
     activeScene->Update(deltaTime);
+
+    PROFILE_SCOPE("Geom Poses");
+    if (!physicsThread) {
+        // Headless: step up to the frame's simulated time, so every run produces the same poses
+        const mjModel* model = mujocoSim->getModel();
+        const mjData* data = mujocoSim->getData();
+        while (model && data->time + 0.5 * model->opt.timestep <= simulatedTime)
+            mujocoSim->step();
+        geomRenderer->Update(*mujocoSim);
+        return;
+    }
+
+    // Non-blocking: picks up the newest physics snapshot if there is one
+    physicsThread->poll();
+    geomRenderer->Update(*physicsThread, PhysicsThread::now());
+}
+
+void ToonApp::UpdateRenderSize() {
+    // While the window is being dragged the last size keeps rendering, stretched by the
+    // post pass, instead of allocating new targets every frame
+    double now = glfwGetTime();
+    if (scrWidth != pendingWidth || scrHeight != pendingHeight) {
+        pendingWidth = scrWidth;
+        pendingHeight = scrHeight;
+        pendingSince = now;
+    }
+    if (pendingWidth > 0 && pendingHeight > 0 && (pendingWidth != renderWidth || pendingHeight != renderHeight) &&
+        now - pendingSince >= kResizeDebounce) {
+        renderWidth = pendingWidth;
+        renderHeight = pendingHeight;
+    }
 }
 
 void ToonApp::RenderScene() {
     if (!regularShader || !camera) return; // Safety check
+    PROFILE_SCOPE("Render Scene");
+    GPU_PROFILE_SCOPE("Render Scene");
 
     glClearColor(bgColor.r, bgColor.g, bgColor.b, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    regularShader->use();
-    
-    glm::mat4 projection = glm::perspective(glm::radians(camera->Zoom), (float)scrWidth / (float)scrHeight, 0.1f, 100.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(camera->Zoom), (float)scrWidth / (float)scrHeight, nearPlane, farPlane);
     glm::mat4 view = camera->GetViewMatrix();
-    
-    regularShader->setMat4("projection", projection);
-    regularShader->setMat4("view", view);
-    regularShader->setVec3("lightPos", lightPos);
-    regularShader->setVec3("viewPos", camera->Position);
-    regularShader->setVec3("lightColor", lightColor);
-
-    glm::mat4 modelMatrix = glm::mat4(1.0f);
-    modelMatrix = glm::translate(modelMatrix, glm::vec3(0.0f, 0.0f, 0.0f)); 
-    modelMatrix = glm::scale(modelMatrix, glm::vec3(0.5f)); 
-    regularShader->setMat4("model", modelMatrix);
-    
-    activeScene->Draw(regularShader.get());
+
+    // Camera and light go up once; every program reads them from the FrameData block
+    FrameUniforms frame;
+    frame.projection = projection;
+    frame.view = view;
+    frame.viewProjection = projection * view;
+    frame.viewPos = glm::vec4(camera->Position, 1.0f);
+    frame.lightPos = glm::vec4(lightPos, 1.0f);
+    frame.lightColor = glm::vec4(lightColor, 1.0f);
+    uniformBuffers->BeginFrame(frame);
+
+    // Scene meshes and MuJoCo geoms (one instanced packet per mesh/primitive group) are
+    // drawn sorted by program, textures and VAO instead of in submission order
+    // LODs are picked by how many pixels their simplification error would cover
+    lodView.cameraPosition = camera->Position;
+    lodView.pixelsPerUnit = gameBuffer->viewportHeight / (2.0f * std::tan(glm::radians(camera->Zoom) * 0.5f));
+
+    // Off-screen models and geoms are culled against their BVHs before anything is queued
+    Frustum frustum(frame.viewProjection);
+
+    {
+        PROFILE_SCOPE("Cull & Submit");
+        renderQueue->Begin(view, farPlane);
+        activeScene->Submit(*renderQueue, regularShader.get(), lodView, frustum);
+        geomRenderer->Submit(*renderQueue, *geomShader, lodView, frustum);
+    }
+    PROFILE_SCOPE("Flush Queue");
+    renderQueue->Flush(*uniformBuffers);
+}
+
+void ToonApp::RenderPostProcess(unsigned int target) {
+    PROFILE_SCOPE("Post Process");
+    GPU_PROFILE_SCOPE("Post Process");
+
+    PostInputs inputs;
+    inputs.color = gameBuffer->GetColorTexture();
+    inputs.depth = gameBuffer->GetDepthTexture();
+    inputs.width = gameBuffer->width;
+    inputs.height = gameBuffer->height;
+    inputs.viewportWidth = gameBuffer->viewportWidth;
+    inputs.viewportHeight = gameBuffer->viewportHeight;
+    inputs.nearPlane = nearPlane;
+    inputs.farPlane = farPlane;
+    postProcess->Execute(inputs, target, scrWidth, scrHeight);
 }
 
 void ToonApp::RenderUI() {
+    PROFILE_SCOPE("UI");
+    GPU_PROFILE_SCOPE("UI");
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
 
     ImGui::Begin("Engine Controls");
     ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+    FrameStats::Summary stats = frameStats.getSummary();
+    ImGui::Text("Frame: p50 %.2f, p95 %.2f, p99 %.2f, max %.2f ms, %llu hitches (%llu total)", stats.p50Ms, stats.p95Ms,
+                stats.p99Ms, stats.maxMs, (unsigned long long)stats.hitches, (unsigned long long)stats.totalHitches);
+    frameStats.copyFrameTimes(frameTimes);
+    ImGui::PlotLines("##frametimes", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, nullptr, 0.0f,
+                     static_cast<float>(std::max(33.3, stats.maxMs)), ImVec2(0.0f, 40.0f));
+    if (ImGui::SliderInt("Stats Window", &statsWindowFrames, 60, 36000))
+        frameStats.setWindow(static_cast<size_t>(statsWindowFrames));
+    if (ImGui::Button("Dump CSV")) {
+        if (!frameStats.writeCsv("frame_stats.csv")) std::cout << "ERROR::FRAMESTATS::WRITE_FAILED frame_stats.csv" << std::endl;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Dump JSON")) {
+        if (!frameStats.writeJson("frame_stats.json")) std::cout << "ERROR::FRAMESTATS::WRITE_FAILED frame_stats.json" << std::endl;
+    }
+    ImGui::Text("Geoms: %d in %d draws, %.1f KB uploaded", geomRenderer->GetInstanceCount(),
+                geomRenderer->GetGroupCount(), geomRenderer->GetLastUploadBytes() / 1024.0f);
+    ImGui::Text("Draws: %d (%d programs, %d materials, %d VAOs bound)", renderQueue->GetPacketCount(),
+                renderQueue->GetProgramSwitches(), renderQueue->GetMaterialSwitches(), renderQueue->GetVAOSwitches());
+    ImGui::Text("Geometry: %d pools, %zu verts, %.1f MB", GeometryPool::GetPoolCount(),
+                GeometryPool::GetTotalVertexCount(), GeometryPool::GetTotalBufferBytes() / (1024.0f * 1024.0f));
+    ImGui::Text("Triangles: %lld (%d geoms simplified)", renderQueue->GetTriangleCount(), geomRenderer->GetSimplifiedInstanceCount());
+    ImGui::Text("Render Targets: %d, %.1f MB, %d FBOs (%llu allocated)", renderTargets->GetTargetCount(),
+                renderTargets->GetBytes() / (1024.0f * 1024.0f), renderTargets->GetFramebufferCount(),
+                (unsigned long long)renderTargets->GetAllocations());
+    ImGui::SliderFloat("LOD Error (px)", &lodView.maxPixelError, 0.0f, 8.0f);
+    ImGui::Text("Visible: %d/%d models, %d/%d geoms", activeScene->GetVisibleCount(),
+                activeScene->GetVisibleCount() + activeScene->GetCulledCount(),
+                geomRenderer->GetVisibleInstanceCount(), geomRenderer->GetInstanceCount());
+    if (ImGui::CollapsingHeader("Post Process")) {
+        for (PostPass& pass : postProcess->GetPasses()) {
+            ImGui::Checkbox(pass.name.c_str(), &pass.enabled);
+            for (PostParam& param : pass.params)
+                if (pass.enabled) ImGui::SliderFloat(param.name.c_str(), &param.value, param.min, param.max);
+        }
+        ImGui::Text("%d draws", postProcess->GetDrawCount());
+    }
+    if (ImGui::CollapsingHeader("Resolution")) {
+        bool dynamic = dynamicResolution.isEnabled();
+        if (ImGui::Checkbox("Dynamic Resolution", &dynamic)) dynamicResolution.setEnabled(dynamic);
+        if (dynamic) {
+            float targetMs = dynamicResolution.getTargetMs();
+            if (ImGui::SliderFloat("Target GPU ms", &targetMs, 4.0f, 33.0f)) dynamicResolution.setTargetMs(targetMs);
+            float minScale = dynamicResolution.getMinScale();
+            float maxScale = dynamicResolution.getMaxScale();
+            bool rangeChanged = ImGui::SliderFloat("Min Scale", &minScale, 0.25f, 1.0f);
+            rangeChanged |= ImGui::SliderFloat("Max Scale", &maxScale, 0.25f, 1.0f);
+            if (rangeChanged) dynamicResolution.setScaleRange(minScale, maxScale);
+        } else {
+            float scale = dynamicResolution.getFixedScale();
+            if (ImGui::SliderFloat("Render Scale", &scale, 0.25f, 1.0f)) dynamicResolution.setFixedScale(scale);
+        }
+        ImGui::Text("Scene: %dx%d (%.0f%%), GPU %.2f ms", gameBuffer->viewportWidth, gameBuffer->viewportHeight,
+                    dynamicResolution.getScale() * 100.0f, dynamicResolution.getGpuMs());
+    }
     ImGui::DragFloat3("Light Pos", &lightPos.x, 0.1f);
     ImGui::ColorEdit3("Light Color", &lightColor.x);
     ImGui::ColorEdit3("Background", &bgColor.x);
+
+    ImGui::Separator();
+    float targetRTF = static_cast<float>(physicsThread->getTargetRTF());
+    if (ImGui::SliderFloat("Target RTF", &targetRTF, 0.0f, 4.0f))
+        physicsThread->setTargetRTF(targetRTF);
+    int catchUpSteps = physicsThread->getMaxCatchUpSteps();
+    if (ImGui::SliderInt("Catch-up Steps", &catchUpSteps, 1, 200))
+        physicsThread->setMaxCatchUpSteps(catchUpSteps);
+    ImGui::Text("Physics: RTF %.2f, %.0f steps/s, %.2f s dropped", physicsThread->getAchievedRTF(),
+                physicsThread->getStepsPerSecond(), physicsThread->getDroppedTime());
+
+    ImGui::Separator();
+    ImGui::SliderFloat("Upload Budget (ms)", &uploadBudgetMs, 0.5f, 16.0f);
+    TextureCache& textureCache = TextureCache::instance();
+    ImGui::Text("Textures: %zu, %.1f MB (%llu hits, %llu misses)", textureCache.getTextureCount(),
+                textureCache.getResidentBytes() / (1024.0f * 1024.0f),
+                (unsigned long long)textureCache.getHits(), (unsigned long long)textureCache.getMisses());
+    ResidencyManager& residency = ResidencyManager::instance();
+    ImGui::Text("Assets: %zu/%zu resident, %.1f MB GPU, %.1f MB CPU (%llu evicted, %llu restored)",
+                residency.getResidentCount(), residency.getAssetCount(), residency.getGpuBytes() / (1024.0f * 1024.0f),
+                residency.getCpuBytes() / (1024.0f * 1024.0f), (unsigned long long)residency.getEvictions(),
+                (unsigned long long)residency.getRestores());
+    if (ImGui::SliderInt("VRAM Budget (MB)", &vramBudgetMB, 0, 4096))
+        residency.setBudget(static_cast<size_t>(vramBudgetMB) * 1024 * 1024);
+    if (!assetLoader->isIdle())
+        ImGui::Text("Loading: %d imports, %zu uploads pending", assetLoader->getPendingImports(), assetLoader->getPendingUploads());
+    ImGui::Checkbox("Profiler", &showProfiler);
+
+    ImGui::Separator();
+    if (frameCapture.isRecording()) {
+        ImGui::Text("Recording: %llu written, %llu dropped, %zu queued, %.2f ms/frame",
+                    (unsigned long long)frameCapture.getWrittenFrames(), (unsigned long long)frameCapture.getDroppedFrames(),
+                    frameCapture.getQueuedFrames(), frameCapture.getLastCpuMs());
+        if (ImGui::Button("Stop Capture (F9)")) ToggleCapture();
+    } else {
+        ImGui::Checkbox("Raw Stream", &captureRaw);
+        ImGui::SameLine();
+        ImGui::Checkbox("Depth", &captureDepth);
+        ImGui::SameLine();
+        if (ImGui::Button("Start Capture (F9)")) ToggleCapture();
+    }
     ImGui::Text(mouseCaptured ? "GAME MODE (ALT to unlock)" : "UI MODE (ALT to capture)");
     ImGui::End();
 
+    if (showProfiler) Profiler::instance().drawWindow(&showProfiler);
+
     // Robot Controls
     // ImGui::Begin("Robot Controls");
     // static float j1=0, j2=0, j3=0, j4=0;
@@ -200,10 +559,7 @@ void ToonApp::framebuffer_size_callback(GLFWwindow* window, int width, int heigh
     app->scrWidth = width;
     app->scrHeight = height;
     glViewport(0, 0, width, height);
-    
-    if(app->gameBuffer) {
-        app->gameBuffer->Resize(width, height);
-    }
+    // Scene targets follow in UpdateRenderSize once the size settles
 }
 
 void ToonApp::mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
@@ -248,6 +604,8 @@ void ToonApp::key_callback(GLFWwindow* window, int key, int scancode, int action
 
     ImGui_ImplGlfw_KeyCallback(window, key, scancode, action, mods);
 
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS) app->ToggleCapture();
+
     if (key == GLFW_KEY_LEFT_ALT && action == GLFW_PRESS) {
         app->mouseCaptured = !app->mouseCaptured;
         if (app->mouseCaptured) glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
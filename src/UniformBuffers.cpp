@@ -0,0 +1,93 @@
+#include "UniformBuffers.h"
+#include <cstring>
+
+UniformBuffers::UniformBuffers(int objectCapacity)
+    : frame(), objectCapacity(objectCapacity), objectCursor(0), objectCount(0) {
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    objectStride = (sizeof(ObjectUniforms) + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, frameUBO);
+
+    glGenBuffers(1, &objectUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, objectUBO);
+    glBufferData(GL_UNIFORM_BUFFER, objectStride * objectCapacity, NULL, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+UniformBuffers::~UniformBuffers() {
+    glDeleteBuffers(1, &frameUBO);
+    glDeleteBuffers(1, &objectUBO);
+}
+
+void UniformBuffers::BeginFrame(const FrameUniforms& frameData) {
+    frame = frameData;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    objectCount = 0;
+}
+
+void UniformBuffers::PushObject(const ObjectUniforms& object) {
+    BindObject(WriteObjects(&object, 1));
+}
+
+void UniformBuffers::PushObject(const glm::mat4& model, const glm::vec3& baseColor, bool hasTexture) {
+    PushObject(MakeObject(model, baseColor, hasTexture));
+}
+
+int UniformBuffers::WriteObjects(const ObjectUniforms* objects, int count) {
+    if (count <= 0) return objectCursor;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, objectUBO);
+
+    if (count > objectCapacity) {
+        // More draws than the ring holds: grow it (the old store is orphaned)
+        while (objectCapacity < count) objectCapacity *= 2;
+        glBufferData(GL_UNIFORM_BUFFER, objectStride * objectCapacity, NULL, GL_DYNAMIC_DRAW);
+        objectCursor = 0;
+    } else if (objectCursor + count > objectCapacity) {
+        // Ring full: orphan the store so in-flight draws keep their data, then start over
+        glBufferData(GL_UNIFORM_BUFFER, objectStride * objectCapacity, NULL, GL_DYNAMIC_DRAW);
+        objectCursor = 0;
+    }
+
+    GLintptr offset = objectCursor * objectStride;
+    if (count == 1) {
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(ObjectUniforms), objects);
+    } else {
+        // Blocks sit at the offset alignment, so spread them out before the single upload
+        staging.resize(objectStride * count);
+        for (int i = 0; i < count; ++i)
+            std::memcpy(&staging[i * objectStride], &objects[i], sizeof(ObjectUniforms));
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, staging.size(), staging.data());
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    int slot = objectCursor;
+    objectCursor += count;
+    objectCount += count;
+    return slot;
+}
+
+void UniformBuffers::BindObject(int slot) {
+    glBindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BLOCK_BINDING, objectUBO, slot * objectStride, sizeof(ObjectUniforms));
+}
+
+ObjectUniforms UniformBuffers::MakeObject(const glm::mat4& model, const glm::vec3& baseColor, bool hasTexture) {
+    ObjectUniforms object = {};
+    object.model = model;
+    object.normalMatrix = glm::transpose(glm::inverse(model)); // once per draw instead of per vertex
+    object.baseColor = glm::vec4(baseColor, 1.0f);
+    object.positionScale = glm::vec4(1.0f);
+    object.positionBias = glm::vec4(0.0f);
+    object.hasTexture = hasTexture ? 1 : 0;
+    return object;
+}
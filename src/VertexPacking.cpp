@@ -0,0 +1,73 @@
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void VertexPacking::quantization(const glm::vec3& boundsMin, const glm::vec3& boundsMax, glm::vec3& scale, glm::vec3& bias) {
+    scale = boundsMax - boundsMin;
+    bias = boundsMin;
+}
+
+PackedVertex VertexPacking::pack(const Vertex& vertex, const glm::vec3& scale, const glm::vec3& bias) {
+    PackedVertex packed = {};
+    for (int axis = 0; axis < 3; ++axis) {
+        // Flat axes (scale 0) store 0 and come back as the bias
+        float t = scale[axis] > 0.0f ? (vertex.Position[axis] - bias[axis]) / scale[axis] : 0.0f;
+        t = std::min(std::max(t, 0.0f), 1.0f);
+        packed.Position[axis] = static_cast<uint16_t>(std::lround(t * 65535.0f));
+    }
+    packed.Normal = packNormal(vertex.Normal);
+    packed.TexCoords[0] = toHalf(vertex.TexCoords.x);
+    packed.TexCoords[1] = toHalf(vertex.TexCoords.y);
+    return packed;
+}
+
+uint16_t VertexPacking::toHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t rawExponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    int exponent = static_cast<int>(rawExponent) - 127 + 15;
+
+    if (rawExponent == 0xFF) return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0)); // inf / nan
+    if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7C00);                              // overflow: inf
+
+    if (exponent <= 0) {
+        // Denormal half (or zero): shift the implicit 1 in, round to nearest even
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // A carry out of the mantissa bumps the exponent, which is the right result
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) ++half;
+    return static_cast<uint16_t>(sign | half);
+}
+
+uint32_t VertexPacking::packNormal(const glm::vec3& normal) {
+    float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+    glm::vec3 n = length > 0.0f ? normal / length : glm::vec3(0.0f);
+
+    auto snorm10 = [](float v) {
+        int q = static_cast<int>(std::lround(std::min(std::max(v, -1.0f), 1.0f) * 511.0f));
+        return static_cast<uint32_t>(q) & 0x3FF;
+    };
+    return snorm10(n.x) | (snorm10(n.y) << 10) | (snorm10(n.z) << 20);
+}
+
+std::vector<uint16_t> VertexPacking::shortIndices(const unsigned int* indices, size_t count) {
+    std::vector<uint16_t> result(count);
+    for (size_t i = 0; i < count; ++i)
+        result[i] = static_cast<uint16_t>(indices[i]);
+    return result;
+}
@@ -1,9 +1,120 @@
 #include "ToonApp.h"
+#include "MujocoBatch.h"
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+
+// Headless rollout benchmark: steps numEnvs copies of the iiwa14 and reports aggregate steps/s.
+// With numThreads == 0 it sweeps 1, 2, 4, ... hardware threads to show scaling.
+static int runBatchBenchmark(int numEnvs, int numSteps, unsigned int numThreads) {
+    MujocoSim sim;
+    sim.loadModel(FileSystem::getPath("assets/google-deepmind mujoco_menagerie main kuka_iiwa_14/iiwa14.xml"));
+
+    std::vector<unsigned int> threadCounts;
+    if (numThreads > 0) {
+        threadCounts.push_back(numThreads);
+    } else {
+        unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int t = 1; t < hardware; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(hardware);
+    }
+
+    std::cout << "Batch: " << numEnvs << " envs x " << numSteps << " steps" << std::endl;
+
+    double baseline = 0.0;
+    for (unsigned int threads : threadCounts) {
+        MujocoBatch batch(sim, numEnvs, threads);
+        std::vector<mjtNum> ctrl(static_cast<size_t>(numEnvs) * batch.nu());
+
+        auto start = std::chrono::steady_clock::now();
+        for (int s = 0; s < numSteps; ++s) {
+            // Phase-shifted sinusoid targets so the rollouts diverge
+            for (int env = 0; env < numEnvs; ++env)
+                for (int i = 0; i < batch.nu(); ++i)
+                    ctrl[static_cast<size_t>(env) * batch.nu() + i] = 0.5 * std::sin(0.01 * s + 0.1 * env + i);
+            batch.step(ctrl.data());
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double stepsPerSecond = seconds > 0.0 ? batch.getTotalSteps() / seconds : 0.0;
+        if (baseline == 0.0) baseline = stepsPerSecond;
+
+        std::cout << "  threads " << std::setw(3) << batch.getNumThreads() << ": "
+                  << std::setw(12) << std::fixed << std::setprecision(0) << stepsPerSecond << " steps/s";
+        // No ratio against a run that did no measurable work
+        if (baseline > 0.0) std::cout << "  (" << std::setprecision(2) << stepsPerSecond / baseline << "x)";
+        std::cout << std::endl;
+    }
+    return 0;
+}
+
+// Whole argument as a decimal integer > 0; anything else is reported and rejected
+static bool parsePositive(const char* flag, const char* text, int& value) {
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed <= 0 || parsed > INT_MAX) {
+        std::cerr << "Error: " << flag << " expects a positive integer, got '" << text << "'" << std::endl;
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    // --batch <envs> [--steps <n>] [--threads <n>] runs without creating a window
+    int batchEnvs = 0;
+    int batchSteps = 1000;
+    unsigned int batchThreads = 0;
+    // --headless [--frames <n>] [--fps <n>] [--size <w>x<h>] [--out <dir>] [--camera <file>] [--depth]
+    // renders offscreen along a camera path and writes PNGs
+    AppConfig config;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            if (!parsePositive("--batch", argv[++i], batchEnvs)) return -1;
+        } else if (std::strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            if (!parsePositive("--steps", argv[++i], batchSteps)) return -1;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            int threads = 0;
+            if (!parsePositive("--threads", argv[++i], threads)) return -1;
+            batchThreads = static_cast<unsigned int>(threads);
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            if (!parsePositive("--frames", argv[++i], config.frames)) return -1;
+        } else if (std::strcmp(argv[i], "--headless") == 0) config.headless = true;
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) config.fps = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) config.outputDir = argv[++i];
+        else if (std::strcmp(argv[i], "--camera") == 0 && i + 1 < argc) config.cameraPath = argv[++i];
+        else if (std::strcmp(argv[i], "--depth") == 0) config.captureDepth = true;
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            int width = 0, height = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+                config.width = width;
+                config.height = height;
+            }
+        }
+    }
+
+    if (batchEnvs > 0) {
+        try {
+            return runBatchBenchmark(batchEnvs, batchSteps, batchThreads);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return -1;
+        }
+    }
 
-int main() {
-    ToonApp app(1280, 1080, "Toon Shaded Engine");
     // Run
     try {
+        ToonApp app(config);
         app.Run();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -11,4 +122,4 @@ int main() {
     }
 
 return 0;
-}
\ No newline at end of file
+}
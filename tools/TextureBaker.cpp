@@ -0,0 +1,86 @@
+// Offline texture baker: source images -> .ttex containers under .cache/textures.
+// The runtime (TextureCache::loadFile) maps these instead of decoding the source.
+//
+// Usage: TextureBaker [--raw] [--no-flip] <image>...
+//   --raw      keep RGB8/RGBA8 levels instead of BC1/BC3 blocks
+//   --no-flip  bake rows top-down (embedded-style); model textures are flipped by default
+
+#include "TextureContainer.h"
+
+#include <stb_image.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char** argv) {
+    bool compress = true;
+    bool flip = true;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--raw") == 0) compress = false;
+        else if (std::strcmp(argv[i], "--no-flip") == 0) flip = false;
+        else inputs.push_back(argv[i]);
+    }
+
+    if (inputs.empty()) {
+        std::cerr << "Usage: TextureBaker [--raw] [--no-flip] <image>..." << std::endl;
+        return 1;
+    }
+
+    int failed = 0;
+    size_t sourceBytes = 0, bakedBytes = 0;
+    for (const std::string& input : inputs) {
+        auto start = std::chrono::steady_clock::now();
+
+        // Same name the runtime derives from the resolved path
+        std::error_code ec;
+        std::filesystem::path resolved = std::filesystem::weakly_canonical(input, ec);
+        std::string name = ec ? input : resolved.generic_string();
+
+        uint64_t sourceHash = 0;
+        if (!TextureContainer::hashSource(input, flip, sourceHash)) {
+            std::cerr << "  cannot read " << input << std::endl;
+            ++failed;
+            continue;
+        }
+
+        std::string output = TextureContainer::pathFor(name);
+        ImageData existing;
+        if (TextureContainer::read(output, sourceHash, existing) && TextureContainer::isCompressed(existing.format) == compress) {
+            std::cout << "  up to date " << input << std::endl;
+            continue;
+        }
+
+        RawImage raw;
+        stbi_set_flip_vertically_on_load(flip);
+        unsigned char* pixels = stbi_load(input.c_str(), &raw.width, &raw.height, &raw.channels, 0);
+        if (!pixels) {
+            std::cerr << "  cannot decode " << input << ": " << stbi_failure_reason() << std::endl;
+            ++failed;
+            continue;
+        }
+        raw.pixels = std::shared_ptr<unsigned char>(pixels, stbi_image_free);
+
+        ImageData image = TextureContainer::bake(raw, compress);
+        if (!TextureContainer::write(output, sourceHash, image)) {
+            std::cerr << "  cannot write " << output << std::endl;
+            ++failed;
+            continue;
+        }
+
+        size_t rawBytes = static_cast<size_t>(raw.width) * raw.height * raw.channels;
+        sourceBytes += rawBytes;
+        bakedBytes += image.bytes();
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  baked " << input << " (" << raw.width << "x" << raw.height << ", "
+                  << image.levels.size() << " levels, " << image.bytes() / 1024 << " KB) in " << ms << " ms" << std::endl;
+    }
+
+    if (sourceBytes > 0)
+        std::cout << "Baked " << bakedBytes / 1024 << " KB with mips from " << sourceBytes / 1024 << " KB of level 0 pixels" << std::endl;
+    return failed == 0 ? 0 : 1;
+}